@@ -0,0 +1,89 @@
+/**
+ * @file amicable.c++
+ * @brief Benchmark of the amicability test run by amicable.
+ *
+ * Benchmark of the amicability test run by amicable on every 4-set. The sets are
+ * read from a file in the format read by amicable or, by default, drawn at
+ * random; a random set is almost never equivalent to an amicable one, so every
+ * transformation is tried, which is the worst case of the test.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./benchmarks/amicable [-n N] [-c count] [file]</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-n N --</strong> length of sequences (default 46)</li>
+ * <li><strong>-c count --</strong> number of random sets (default 20000)</li>
+ * <li><strong>file --</strong> sets read instead of the random ones</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <fstream>
+# include <random>
+# include <sstream>
+
+# include <getopt.h>
+
+# include <bench.h++>
+# include <set.h++>
+
+int main(int argc, char *argv[])
+{
+  unsigned n{46};
+  std::size_t count{20000};
+
+  bool ok{true};
+  int c{};
+  while ( (c = getopt(argc, argv, "n:c:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'n': ss >> n; break;
+    case 'c': ss >> count; break;
+    default: ok = false; break;
+    }
+  }
+
+  if ( !ok || argc - optind > 1 || n < 4 || (n & 1U) || count == 0 ) {
+    std::cerr << "USAGE -- ./benchmarks/amicable [-n <N>] [-c <count>] [file]\n"
+              << std::flush;
+    return 1;
+  }
+
+  std::vector<set_t> S;
+  if ( optind < argc ) {
+    std::ifstream is{argv[optind]};
+    set_t s{n};
+    while ( is >> s ) S.push_back(s);
+  }
+  else {
+    std::mt19937_64 gen{SEED};
+    std::stringstream ss;
+    for ( std::size_t i{0}; i < count * 4 * n; i++ )
+      ss << ((gen() & 1U) ? -1 : 1) << " ";
+    set_t s{n};
+    while ( ss >> s ) S.push_back(s);
+  }
+  if ( S.empty() ) {
+    std::cerr << "ERROR -- no sets to test\n" << std::flush;
+    return 1;
+  }
+
+  std::size_t found{};
+  double const t{best_of([&] {
+    std::vector<set_t> T{S};
+    found = 0;
+    auto const t0{std::chrono::steady_clock::now()};
+    for ( auto& s : T ) found += s.amicable();
+    return std::chrono::steady_clock::now() - t0;
+  })};
+
+  report("amicable", "us/set", 1e6 * t / S.size(), "us");
+  report("amicable", "sets/s", S.size() / t, "1/s");
+  report("amicable", "amicable sets", found, "");
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file bench.h++
+ * @brief Helpers shared by the benchmarks run by make bench.
+ *
+ * Helpers shared by the benchmarks run by make bench: timing, reporting and the
+ * generation of synthetic candidates. Every benchmark draws its input from a
+ * generator with a fixed seed and reports the best of several repetitions, so
+ * results are reproducible on a given machine.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_BENCH_HPP
+# define INCLUDED_BENCH_HPP
+
+# include <chrono>
+# include <cmath>
+# include <cstdint>
+# include <iomanip>
+# include <iostream>
+# include <random>
+# include <sstream>
+# include <string>
+# include <type_traits>
+# include <vector>
+
+# define SEED 20251016ULL
+# define REPS 5
+
+/**
+ * @brief Best time of several runs of a function.
+ *
+ * Best time of several runs of a function. A function returning a duration
+ * times itself, e.g. to leave out the preparation of its input.
+ *
+ * @param f Function being timed.
+ * @param reps Number of runs.
+ * @return double Shortest time of a run in seconds.
+ */
+template <typename F>
+double best_of(F&& f, unsigned reps = REPS)
+{
+  double best{};
+  for ( unsigned r{0}; r < reps; r++ ) {
+    std::chrono::duration<double> t{};
+    if constexpr ( std::is_void_v<std::invoke_result_t<F&>> ) {
+      auto const t0{std::chrono::steady_clock::now()};
+      f();
+      t = std::chrono::steady_clock::now() - t0;
+    }
+    else t = f();
+    if ( r == 0 || t.count() < best ) best = t.count();
+  }
+  return best;
+}
+
+/**
+ * @brief Writes one result of a benchmark.
+ *
+ * Writes one result of a benchmark to stdout as a line holding the benchmark,
+ * the quantity measured, its value and its unit.
+ *
+ * @param bench Name of the benchmark.
+ * @param what Quantity measured.
+ * @param value Value measured.
+ * @param unit Unit of the value.
+ */
+static inline
+void report(std::string const& bench, std::string const& what, double value,
+            std::string const& unit)
+{
+  std::cout << std::left << std::setw(12) << bench << std::setw(28) << what
+            << std::right << std::setw(14) << std::setprecision(6) << value
+            << " " << unit << '\n' << std::flush;
+}
+
+/**
+ * @brief Psd values of a sequence at frequencies 1 to n/2.
+ *
+ * Psd values of a sequence at frequencies 1 to n/2, computed directly from the
+ * definition so the benchmarks do not depend on the code they measure.
+ *
+ * @param s Sequence of entries +1 or -1.
+ * @return Psd values.
+ */
+static inline
+std::vector<double> psd(std::vector<int> const& s)
+{
+  std::size_t const n{s.size()};
+  std::vector<double> P(n / 2);
+  for ( std::size_t k{1}; k <= n / 2; k++ ) {
+    double re{}, im{};
+    for ( std::size_t j{0}; j < n; j++ ) {
+      re += s[j] * std::cos(2.0 * M_PI * j * k / n);
+      im -= s[j] * std::sin(2.0 * M_PI * j * k / n);
+    }
+    P[k - 1] = re * re + im * im;
+  }
+  return P;
+}
+
+/**
+ * @brief Generates synthetic candidates in the text format written by A and B.
+ *
+ * Generates synthetic candidates in the text format written by A and B: random
+ * sequences of length n passing the psd test of A and B, i.e. whose psd values
+ * are all at most 4n+4.
+ *
+ * @param n Length of sequences.
+ * @param count Number of sequences.
+ * @param seed Seed of the generator.
+ * @return Candidates, one per line.
+ */
+static inline
+std::string synthetic(unsigned n, std::size_t count, std::uint64_t seed)
+{
+  std::mt19937_64 gen{seed};
+  std::ostringstream os;
+  std::vector<int> s(n);
+  for ( std::size_t i{0}; i < count; ) {
+    for ( auto& x : s ) x = (gen() & 1U) ? -1 : 1;
+    std::vector<double> const P{psd(s)};
+    bool ok{true};
+    for ( double x : P ) ok = ok && x <= 4.0 * n + 4.0;
+    if ( !ok ) continue;
+
+    for ( int x : s ) os << x << " ";
+    os << "\t\t";
+    for ( double x : P ) os << x << " ";
+    os << '\n';
+    i++;
+  }
+  return os.str();
+}
+
+# endif
@@ -0,0 +1,90 @@
+/**
+ * @file check_func.c++
+ * @brief Benchmark of the psd test run by A and B on every bracelet.
+ *
+ * Benchmark of the psd test run by A and B on every bracelet. A stream of
+ * sequences is generated in which, as in the bracelet traversal, each sequence
+ * differs from the previous one in a short random suffix. The stream is run
+ * through check_func with the full FFT and with the incremental engine.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./benchmarks/check_func [-n N] [-c count] [-p estimate|measure|patient]</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-n N --</strong> length of sequences (default 46)</li>
+ * <li><strong>-c count --</strong> number of sequences (default 100000)</li>
+ * <li><strong>-p flags --</strong> fftw3 planner flags (default measure)</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <random>
+# include <sstream>
+# include <string>
+
+# include <getopt.h>
+
+# include <args.h++>
+# include <bench.h++>
+
+int main(int argc, char *argv[])
+{
+  unsigned n{46}, flags{FFTW_MEASURE};
+  std::size_t count{100000};
+  std::string planner{"measure"};
+
+  bool ok{true};
+  int c{};
+  while ( (c = getopt(argc, argv, "n:c:p:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'n': ss >> n; break;
+    case 'c': ss >> count; break;
+    case 'p': planner = optarg; break;
+    default: ok = false; break;
+    }
+  }
+
+  if ( planner == "estimate" ) flags = FFTW_ESTIMATE;
+  else if ( planner == "patient" ) flags = FFTW_PATIENT;
+  else if ( planner != "measure" ) ok = false;
+
+  if ( !ok || optind != argc || n < 4 || (n & 1U) || count == 0 ) {
+    std::cerr << "USAGE -- ./benchmarks/check_func [-n <N>] [-c <count>] "
+              << "[-p estimate|measure|patient]\n" << std::flush;
+    return 1;
+  }
+
+  std::mt19937_64 gen{SEED};
+  std::vector<seq> S(count, seq(n + 1, 0));
+  for ( std::size_t j{1}; j <= n; j++ ) S[0][j] = gen() & 1U;
+  for ( std::size_t i{1}; i < count; i++ ) {
+    S[i] = S[i - 1];
+    std::size_t r{1};
+    while ( r < n && (gen() & 1U) ) r++;
+    for ( std::size_t j{n + 1 - r}; j <= n; j++ ) S[i][j] = gen() & 1U;
+  }
+
+  for ( bool incremental : {false, true} ) {
+    args_t args{n, flags};
+    args.incremental = incremental;
+    std::size_t passes{};
+    double const t{best_of([&] {
+      passes = 0;
+      args.stale = ~0U;
+      for ( auto const& a : S ) passes += check_func(a, args);
+    })};
+    args.destroy();
+
+    std::string const engine{incremental ? "inc" : "fft"};
+    report("check_func", engine + " ns/bracelet", 1e9 * t / count, "ns");
+    report("check_func", engine + " bracelets/s", count / t, "1/s");
+    report("check_func", engine + " passes", passes, "");
+  }
+
+  return 0;
+}
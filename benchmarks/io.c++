@@ -0,0 +1,111 @@
+/**
+ * @file io.c++
+ * @brief Benchmark of reading and writing candidate files.
+ *
+ * Benchmark of reading and writing candidate files on synthetic candidates; see
+ * synthetic. The parsing and formatting of the text format and the writing,
+ * loading and sorting of binary candidate files are timed. A binary file is
+ * loaded from the page cache, since it has just been written, and every psd
+ * value and packed sequence is read, so its pages are faulted in within the
+ * timed region.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./benchmarks/io [-n N] [-c count] [-j threads] [-o file]</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-n N --</strong> length of sequences (default 46)</li>
+ * <li><strong>-c count --</strong> number of sequences (default 200000)</li>
+ * <li><strong>-j threads --</strong> number of threads parsing and sorting
+ * (default 1)</li>
+ * <li><strong>-o file --</strong> scratch binary file, removed at exit (default
+ * bench-io.bin)</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <cstdio>
+# include <sstream>
+# include <string>
+
+# include <getopt.h>
+
+# include <bench.h++>
+# include <psdfile.h++>
+
+int main(int argc, char *argv[])
+{
+  unsigned n{46}, threads{1};
+  std::size_t count{200000};
+  std::string path{"bench-io.bin"};
+
+  bool ok{true};
+  int c{};
+  while ( (c = getopt(argc, argv, "n:c:j:o:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'n': ss >> n; break;
+    case 'c': ss >> count; break;
+    case 'j': ss >> threads; break;
+    case 'o': path = optarg; break;
+    default: ok = false; break;
+    }
+  }
+
+  if ( !ok || optind != argc || n < 4 || (n & 1U) || count == 0 ||
+       threads == 0 ) {
+    std::cerr << "USAGE -- ./benchmarks/io [-n <N>] [-c <count>] [-j <threads>] "
+              << "[-o <file>]\n" << std::flush;
+    return 1;
+  }
+
+  std::string const text{synthetic(n, count, SEED)};
+  double const mb{text.size() / 1e6};
+
+  double const parse{best_of([&] {
+    psdfile_t F;
+    F.parse(text, threads);
+  })};
+
+  psdfile_t F;
+  F.parse(text, threads);
+  double const format{best_of([&] {
+    std::ostringstream os;
+    F.write_text(os);
+  })};
+
+  double const write{best_of([&] { F.write(path); })};
+
+  volatile double sink{};
+  double const load{best_of([&] {
+    psdfile_t G;
+    G.load(path);
+    double sum{};
+    for ( std::size_t i{0}; i < G.count * G.len; i++ ) sum += G.psd[i];
+    for ( std::size_t i{0}; i < G.count * G.words; i++ ) sum += G.bits[i] & 1U;
+    sink = sum;
+  })};
+
+  double const sort{best_of([&] {
+    psdfile_t G;
+    G.load(path);
+    auto const t0{std::chrono::steady_clock::now()};
+    G.sort(threads);
+    return std::chrono::steady_clock::now() - t0;
+  })};
+
+  std::remove(path.c_str());
+
+  report("io", "text parse MB/s", mb / parse, "MB/s");
+  report("io", "text parse lines/s", count / parse, "1/s");
+  report("io", "text format MB/s", mb / format, "MB/s");
+  report("io", "text format lines/s", count / format, "1/s");
+  report("io", "binary write seqs/s", count / write, "1/s");
+  report("io", "binary load seqs/s", count / load, "1/s");
+  report("io", "sort seqs/s", count / sort, "1/s");
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file join.c++
+ * @brief Benchmark of the hash join run by whiteman.
+ *
+ * Benchmark of the hash join run by whiteman on synthetic candidate tables; see
+ * synthetic. The build of the index of pairs and the search of every row are
+ * timed separately.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./benchmarks/join [-n N] [-c count] [-j threads]</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-n N --</strong> length of sequences (default 26)</li>
+ * <li><strong>-c count --</strong> number of sequences of each type (default
+ * 2000)</li>
+ * <li><strong>-j threads --</strong> number of threads building the index
+ * (default 1)</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <algorithm>
+# include <memory>
+# include <sstream>
+# include <string>
+
+# include <getopt.h>
+
+# include <bench.h++>
+# include <join.h++>
+
+int main(int argc, char *argv[])
+{
+  unsigned n{26}, threads{1};
+  std::size_t count{2000};
+
+  bool ok{true};
+  int c{};
+  while ( (c = getopt(argc, argv, "n:c:j:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'n': ss >> n; break;
+    case 'c': ss >> count; break;
+    case 'j': ss >> threads; break;
+    default: ok = false; break;
+    }
+  }
+
+  if ( !ok || optind != argc || n < 4 || (n & 1U) || count == 0 ||
+       threads == 0 ) {
+    std::cerr << "USAGE -- ./benchmarks/join [-n <N>] [-c <count>] [-j <threads>]\n"
+              << std::flush;
+    return 1;
+  }
+
+  psdfile_t A, B;
+  A.parse(synthetic(n, count, SEED));
+  B.parse(synthetic(n, count, SEED + 1));
+  A.sort(threads);
+  B.sort(threads);
+
+  std::unique_ptr<join_t> J;
+  double const build{best_of([&] {
+    J.reset();
+    J = std::make_unique<join_t>(A, B, threads);
+  })};
+
+  std::size_t found{};
+  double const search{best_of([&] {
+    std::ostringstream os;
+    J->rows(0, A.count, os);
+    std::string const s{os.str()};
+    found = std::count(s.begin(), s.end(), '\n') / 5;
+  })};
+
+  report("join", "build s", build, "s");
+  report("join", "pairs indexed", J->index.size(), "");
+  report("join", "search s", search, "s");
+  report("join", "rows/s", A.count / search, "1/s");
+  report("join", "row pairs/s", double(A.count) * B.count / search, "1/s");
+  report("join", "4-sets found", found, "");
+
+  return 0;
+}
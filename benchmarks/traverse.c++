@@ -0,0 +1,142 @@
+/**
+ * @file traverse.c++
+ * @brief Benchmark of the bracelet traversal run by every thread and shard of A
+ * and B.
+ *
+ * Benchmark of the bracelet traversal run by every thread and shard of A and B.
+ * The traversal of A or B is run once with a check function rejecting every
+ * bracelet, which times the traversal alone, and once with check_func, which
+ * times a single-threaded run. Since every thread and every shard walks the
+ * whole traversal and tests only the bracelets of its own blocks, only the
+ * tests are divided between them: the ratio of the two times is the most that
+ * threads and shards together can speed up a run.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./benchmarks/traverse [-n N] [-t A|B] [-e fft|inc]</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-n N --</strong> length of sequences (default 24)</li>
+ * <li><strong>-t A|B --</strong> traversal of A (default) or of B</li>
+ * <li><strong>-e fft|inc --</strong> engine of check_func (default fft)</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <sstream>
+# include <string>
+
+# include <getopt.h>
+
+# include <args.h++>
+# include <bench.h++>
+# include <combinat.h>
+
+/**
+ * @brief Counts a bracelet and rejects it.
+ *
+ * Counts a bracelet and rejects it.
+ *
+ * @param a Bracelet.
+ * @param count Number of bracelets visited.
+ * @return bool False.
+ */
+static
+bool reject(seq const&, unsigned long long& count)
+{
+  count++;
+  return false;
+}
+
+/**
+ * @brief Never called since every bracelet is rejected.
+ *
+ * Never called since every bracelet is rejected.
+ */
+static
+void ignore(seq const&, unsigned long long&) {}
+
+/**
+ * @brief Runs the traversal of A or B.
+ *
+ * Runs the traversal of A or B, as in A.c++ and B.c++, with the given check and
+ * encounter functions.
+ *
+ * @param n Length of sequences.
+ * @param B Whether the traversal of B is run.
+ * @param check Check function.
+ * @param encounter Encounter function.
+ * @param x Object passed to the functions.
+ */
+template <typename T>
+void traverse(unsigned n, bool B, bool (*check)(seq const&, T&),
+              void (*encounter)(seq const&, T&), T& x)
+{
+  if ( B ) {
+    combinat::neck_t<T> neck{n, 2U, std::vector<unsigned>{0, (n+2)/2, (n-2)/2}};
+    neck.checkfunc = check;
+    neck.encounterfunc = encounter;
+    combinat::FCBracelet<T>(neck, x, NULL);
+  }
+  else {
+    combinat::neck_t<T> neck{n, 2U};
+    neck.checkfunc = check;
+    neck.encounterfunc = encounter;
+    combinat::FCBraceletUnlabeled<T>(neck, x, NULL);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned n{24};
+  std::string type{"A"}, engine{"fft"};
+
+  bool ok{true};
+  int c{};
+  while ( (c = getopt(argc, argv, "n:t:e:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'n': ss >> n; break;
+    case 't': type = optarg; break;
+    case 'e': engine = optarg; break;
+    default: ok = false; break;
+    }
+  }
+
+  if ( !ok || optind != argc || n < 4 || (n & 1U) ||
+       (type != "A" && type != "B") || (engine != "fft" && engine != "inc") ) {
+    std::cerr << "USAGE -- ./benchmarks/traverse [-n <N>] [-t A|B] "
+              << "[-e fft|inc]\n" << std::flush;
+    return 1;
+  }
+  bool const B{type == "B"};
+
+  unsigned long long count{};
+  double const walk{best_of([&] {
+    count = 0;
+    traverse<unsigned long long>(n, B, reject, ignore, count);
+  })};
+
+  args_t args{n};
+  args.incremental = engine == "inc";
+  std::ostringstream out;
+  args.os = &out;
+  double const full{best_of([&] {
+    out.str("");
+    args.stale = ~0U;
+    traverse<args_t>(n, B, check_func, encounter_func, args);
+  })};
+  args.destroy();
+
+  std::string const bench{"traverse " + type};
+  report(bench, "bracelets", count, "");
+  report(bench, "traversal ns/bracelet", 1e9 * walk / count, "ns");
+  report(bench, engine + " run ns/bracelet", 1e9 * full / count, "ns");
+  report(bench, "traversal share", 100.0 * walk / full, "%");
+  report(bench, "thread/shard ceiling", full / walk, "x");
+
+  return 0;
+}
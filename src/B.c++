@@ -8,46 +8,57 @@
  *
  * <dl>
  * <dt><strong>Usage</strong></dt>
- * <dd>./B N</dd>
+ * <dd>./B [-j threads] [-k] [-b blocksize] [-o file] [-f text|bin]
+ * [-e fft|inc] [-s k/m] [-c checkpoint] N</dd>
  * </dl>
  * <strong>Parameters</strong>
  * <ul>
  * <li><strong>N --</strong> length of sequences being generated</li>
+ * <li><strong>-j threads --</strong> number of worker threads (default 1)</li>
+ * <li><strong>-k --</strong> keep the output in the single-threaded order</li>
+ * <li><strong>-b blocksize --</strong> number of bracelets per block of work
+ * handed to a thread (default 4096)</li>
+ * <li><strong>-o file --</strong> write the candidates to file instead of
+ * stdout</li>
+ * <li><strong>-f text|bin --</strong> write text (default) or a binary
+ * candidate file, see psdfile.h++; binary output requires -o</li>
+ * <li><strong>-e fft|inc --</strong> run a full FFT for every bracelet (default)
+ * or update the transform of the previous bracelet incrementally; the output is
+ * the same</li>
+ * <li><strong>-s k/m --</strong> test only shard k of m, 0 <= k < m: the blocks
+ * whose index is k modulo m; runs of every shard with the same blocksize
+ * together test every bracelet once, and their outputs are combined by
+ * psdmerge</li>
+ * <li><strong>-c checkpoint --</strong> record the progress of the run in the
+ * checkpoint file every 30 seconds and, if the file exists, resume the run it
+ * records; requires -o and keeps the single-threaded order</li>
  * </ul>
+ * Every thread and every shard walks the whole bracelet traversal and tests
+ * only the bracelets of its own blocks, so only the psd tests are divided
+ * between them. If the traversal takes a share t of a single-threaded run,
+ * threads and shards together speed a run up by at most 1/t;
+ * ./benchmarks/traverse -t B measures t and this ceiling for a given N.
  *
  * @author Thomas Pender
  * @date 10/2025
  * @copyright GNU Public License
  */
-# include <sstream>
-
 # include <args.h++>
 # include <combinat.h>
 
 int main(int argc, char *argv[])
 {
-  if ( argc < 2 ) {
-    std::cerr << "USAGE -- ./B.out <N>\n" << std::flush;
-    return 1;
-  }
-
-  unsigned n{};
-  {
-    std::stringstream ss{argv[1]};
-    ss >> n;
-  }
-
-  if ( n & 1U ) {
-    std::cerr << "ERROR -- parameter <N> must be even\n" << std::flush;
-    return 1;
-  }
+  opts_t opts{};
+  if ( !parse_opts(argc, argv, opts) ) return 1;
 
-  args_t args{n};
-  combinat::neck_t<args_t> neck{n, 2U, std::vector<unsigned>{0, (n+2)/2, (n-2)/2}};
-  neck.checkfunc = check_func;
-  neck.encounterfunc = encounter_func;
+  bool ok{enumerate(opts, [&opts](args_t& args) {
+    unsigned n{opts.n};
+    combinat::neck_t<args_t> neck{n, 2U, std::vector<unsigned>{0, (n+2)/2, (n-2)/2}};
+    neck.checkfunc = check_func;
+    neck.encounterfunc = encounter_func;
 
-  combinat::FCBracelet<args_t>(neck, args, NULL);
+    combinat::FCBracelet<args_t>(neck, args, NULL);
+  })};
 
-  return 0;
+  return ok ? 0 : 1;
 }
@@ -6,26 +6,46 @@
  *
  * File to generate executable that takes complementary 4 sets and exhaustively
  * searches for whether each set can be transformed into an amicable set. The
- * executable reads from stdin.
+ * executable reads from stdin or the given file.
+ *
+ * With several threads, or when reading a file, the executable runs as a
+ * pipeline: a reader thread parses the input, memory mapped if it is a file, into
+ * batches of packed 4-sets; worker threads, each holding its own set_t object,
+ * test the sets of a batch; and the results are written in input order.
  *
  * <dl>
  * <dt><strong>Usage</strong></dt>
- * <dd>./amicable N</dd>
+ * <dd>./amicable [-j threads] [-b batch] N [file]</dd>
  * <dl>
  * <strong>Parameters</strong>
  * <ul>
  * <li><strong>N --</strong> length of sequences being read in</li>
+ * <li><strong>file --</strong> file of 4-sets read instead of stdin</li>
+ * <li><strong>-j threads --</strong> number of worker threads (default 1)</li>
+ * <li><strong>-b batch --</strong> number of 4-sets per batch handed to a
+ * worker (default 256)</li>
  * </ul>
  *
  * @author Thomas Pender
  * @date 10/2025
  * @copyright GNU Public License
  */
+# include <cstdint>
+# include <cstdio>
 # include <iostream>
 # include <sstream>
+# include <string>
+# include <thread>
 # include <vector>
 
+# include <fcntl.h>
+# include <getopt.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
 # include <set.h++>
+# include <workers.h++>
 
 static inline
 int cross_corr(int j, seq const& s1, seq const& s2)
@@ -40,26 +60,222 @@ int cross_corr(int j, seq const& s1, seq const& s2)
   return sum;
 }
 
+/**
+ * @brief Batch of 4-sets read from the input.
+ *
+ * Batch of 4-sets read from the input.
+ */
+struct batch_t
+{
+  std::size_t index{};          ///< position of the batch in the input
+  std::vector<std::int8_t> v{}; ///< entries of the 4-sets, 4n per set
+};
+
+/**
+ * @brief Parses the input into batches of 4-sets.
+ *
+ * Parses the input into batches of 4-sets. A file is memory mapped and parsed in
+ * place; stdin is read in large chunks. A trailing incomplete 4-set is dropped.
+ * Reading stops with an error at the first entry that is not 1, +1 or -1; the
+ * 4-sets completed before it are still pushed.
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>mmap</li>
+ * <li>std::fread</li>
+ * </ul>
+ *
+ * @post Every batch has been pushed and the queue is closed.
+ *
+ * @param path File being read; stdin if empty.
+ * @param n Length of sequences.
+ * @param size Number of 4-sets per batch.
+ * @param Q Queue the batches are pushed to.
+ * @return bool True if the input could be read and holds only entries 1 and
+ * -1; false otherwise.
+ */
+static
+bool read_input(std::string const& path, unsigned n, std::size_t size,
+                queue_t<batch_t>& Q)
+{
+  std::size_t const per{std::size_t{4} * n * size};
+  batch_t b{0, {}};
+  b.v.reserve(per);
+  bool ok{true};
+
+  auto feed = [&](char const *p, char const *e) {
+    while ( p < e ) {
+      while ( p < e && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r') )
+        p++;
+      if ( p == e ) break;
+
+      bool minus{*p == '-'};
+      if ( minus || *p == '+' ) p++;
+      char const *digits{p};
+      int x{0};
+      for ( ; p < e && *p >= '0' && *p <= '9'; p++ )
+        x = (x < 2 ? 10 * x + (*p - '0') : 2);
+      if ( p == digits || x != 1 ) {
+        std::cerr << "ERROR -- entries of the input must be 1 or -1\n"
+                  << std::flush;
+        return false;
+      }
+      b.v.push_back(std::int8_t(minus ? -1 : 1));
+
+      if ( b.v.size() == per ) {
+        std::size_t i{b.index};
+        Q.push(std::move(b));
+        b = batch_t{i + 1, {}};
+        b.v.reserve(per);
+      }
+    }
+    return true;
+  };
+
+  if ( !path.empty() ) {
+    int fd{::open(path.c_str(), O_RDONLY)};
+    struct stat st{};
+    void *map{MAP_FAILED};
+    if ( fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0 )
+      map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ( fd >= 0 ) ::close(fd);
+
+    if ( map != MAP_FAILED ) {
+      madvise(map, st.st_size, MADV_SEQUENTIAL);
+      char const *p{static_cast<char const*>(map)};
+      ok = feed(p, p + st.st_size);
+      munmap(map, st.st_size);
+    }
+    else if ( fd < 0 || st.st_size > 0 ) {
+      std::cerr << "ERROR -- cannot read " << path << '\n' << std::flush;
+      ok = false;
+    }
+  }
+  else {
+    std::vector<char> buf(std::size_t{1} << 20U);
+    std::size_t carry{0}, got{};
+    while ( (got = std::fread(buf.data() + carry, 1, buf.size() - carry,
+                              stdin)) > 0 ) {
+      char const *p{buf.data()}, *e{buf.data() + carry + got};
+      char const *cut{e};
+      while ( cut > p && cut[-1] != ' ' && cut[-1] != '\n' ) cut--;
+      if ( cut == p ) cut = e;
+      if ( !(ok = feed(p, cut)) ) break;
+      carry = e - cut;
+      std::copy(cut, e, buf.data());
+    }
+    if ( ok ) ok = feed(buf.data(), buf.data() + carry);
+  }
+
+  b.v.resize(b.v.size() - b.v.size() % (std::size_t{4} * n));
+  if ( !b.v.empty() ) Q.push(std::move(b));
+  Q.close();
+  return ok;
+}
+
+/**
+ * @brief Tests the 4-sets of the input on a pipeline of threads.
+ *
+ * Tests the 4-sets of the input on a pipeline of threads: a reader thread, the
+ * given number of worker threads and the writer, a sched_t object writing the
+ * output of each batch in input order.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>read_input</li>
+ * <li>set_t::amicable</li>
+ * <li>run_workers</li>
+ * </ul>
+ *
+ * @post The amicable sets found are written to stdout in input order.
+ *
+ * @param path File being read; stdin if empty.
+ * @param n Length of sequences.
+ * @param threads Number of worker threads.
+ * @param size Number of 4-sets per batch.
+ * @return bool True if the input could be read and holds only entries 1 and
+ * -1; false otherwise.
+ */
+static
+bool pipeline(std::string const& path, unsigned n, unsigned threads,
+              std::size_t size)
+{
+  queue_t<batch_t> Q{std::size_t{4} * threads};
+  sched_t sched{1, true, [](std::string& s) {std::cout << s << std::flush;}};
+
+  bool ok{};
+  std::thread reader{[&] {ok = read_input(path, n, size, Q);}};
+
+  run_workers(threads, [&](unsigned) {
+    set_t S{n};
+    S.r = S.s;
+    std::ostringstream os;
+    batch_t b;
+
+    while ( Q.pop(b) ) {
+      for ( std::size_t i{0}; i < b.v.size(); i += std::size_t{4} * n ) {
+        std::int8_t const *v{b.v.data() + i};
+        for ( std::size_t k{0}; k < 4; k++ )
+          for ( std::size_t j{0}; j < n; j++ ) {
+            S.s[k][j] = v[k * n + j];
+            S.r[k][n - 1 - j] = v[k * n + j];
+          }
+        if ( S.amicable() ) os << S << '\n';
+      }
+      std::string out{os.str()};
+      os.str({});
+      sched.submit(b.index, out);
+    }
+  });
+
+  reader.join();
+  sched.flush();
+  return ok;
+}
+
 int main(int argc, char *argv[])
 {
-  if ( argc < 2 ) {
-    std::cerr << "USAGE -- ./amicable.out <N>\n" << std::flush;
+  unsigned threads{1};
+  std::size_t size{256};
+
+  int c{};
+  while ( (c = getopt(argc, argv, "j:b:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'j': ss >> threads; break;
+    case 'b': ss >> size; break;
+    default: optind = argc; break;
+    }
+  }
+
+  if ( optind != argc - 1 && optind != argc - 2 ) {
+    std::cerr << "USAGE -- ./amicable [-j <threads>] [-b <batch>] <N> [file]\n"
+              << std::flush;
     return 1;
   }
 
   unsigned n{};
   {
-    std::stringstream ss{argv[1]};
+    std::stringstream ss{argv[optind]};
     ss >> n;
   }
   if ( n & 1U ) {
     std::cerr << "ERROR -- <N> must be even\n" << std::flush;
     return 1;
   }
+  if ( threads == 0 || size == 0 ) {
+    std::cerr << "ERROR -- <threads> and <batch> must be positive\n"
+              << std::flush;
+    return 1;
+  }
+
+  std::string path{optind == argc - 2 ? argv[optind + 1] : ""};
+  if ( threads > 1 || !path.empty() )
+    return pipeline(path, n, threads, size) ? 0 : 1;
 
   set_t s{n};
   while ( std::cin >> s ) {
-    s.amicable();
+    if ( s.amicable() ) std::cout << s << '\n';
   }
 
   return 0;
@@ -11,9 +11,55 @@
  * @date 10/2025
  * @copyright GNU Public License
  */
+# include <chrono>
+# include <cstdio>
+# include <fstream>
+
+# include <fcntl.h>
+# include <getopt.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
 # include <args.h++>
 
 # define ERR 0.00005
+# define REFRESH 256
+# define CHECKPOINT 30
+
+/**
+ * @brief Decides whether the proposed bracelet belongs to the worker.
+ *
+ * Decides whether the proposed bracelet belongs to the worker. Once the
+ * traversal passes the end of the block held, the block is handed back and a new
+ * one is claimed; blocks are claimed in increasing order, so the new block always
+ * lies at or ahead of the current bracelet.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>close_block</li>
+ * <li>sched_t::claim</li>
+ * </ul>
+ *
+ * @pre The args_t object has a scheduler.
+ *
+ * @post The bracelet count is incremented.
+ *
+ * @param args Arguments used in bracelet generating routines.
+ * @return bool True if the bracelet lies in the block held; false otherwise.
+ */
+static inline
+bool owned(args_t& args)
+{
+  unsigned long long i{args.count++};
+  while ( i >= args.end ) {
+    close_block(args);
+    args.block = args.sched->claim();
+    args.begin = args.sched->start(args.block);
+    args.end = args.begin + args.sched->size;
+    args.active = true;
+  }
+  return i >= args.begin;
+}
 
 /**
  * @brief Power spectral density test of sequence.
@@ -39,20 +85,86 @@ bool psd_test(args_t& args)
   for ( std::size_t i{1}; i < (args.n >> 1U); i++ ) {
     val = (args.out[i] * args.out[i]) +
       (args.out[args.n - i] * args.out[args.n - i]);
-    if ( val > args.bound + ERR ) return false;
+    if ( val > args.bound + ERR ) {
+      count_reject(i);
+      return false;
+    }
     args.psd[i] = val;
   }
 
   val = args.out[args.n >> 1U] * args.out[args.n >> 1U];
-  if ( val > args.bound + ERR ) return false;
+  if ( val > args.bound + ERR ) {
+    count_reject(args.n >> 1U);
+    return false;
+  }
   args.psd[args.n >> 1U] = val;
 
   return true;
 }
 
+/**
+ * @brief Updates the transform held in the fftw3 output array to a new sequence.
+ *
+ * Updates the transform held in the fftw3 output array to a new sequence. The
+ * fftw3 input array holds the previous sequence; an R2HC transform does not
+ * overwrite its input. Changing entry p by d adds d cos(2 pi pk/n) to the real
+ * part and -d sin(2 pi pk/n) to the imaginary part of frequency k.
+ *
+ * @pre The fftw3 output array holds the transform of the fftw3 input array.
+ * @pre Sequence a has first element 0 and remaining elements 0 or 1.
+ *
+ * @post The fftw3 input array holds the new sequence and, unless false is
+ * returned, the output array holds its transform.
+ *
+ * @param a Sequence constructed from bracelet routine.
+ * @param args Arguments used in bracelet generating routines.
+ * @return bool True if the transform was updated; false if too many entries
+ * changed and the caller has to run a full FFT.
+ */
+static inline
+bool update(seq const& a, args_t& args)
+{
+  unsigned const n{args.n}, h{args.n >> 1U};
+  unsigned changed{0};
+  for ( unsigned i{0}; i < n; i++ )
+    if ( args.in[i] != (a[i + 1] == 1 ? -1 : 1) ) {
+      if ( changed == args.limit ) return false;
+      args.pos[changed++] = i;
+    }
+
+  for ( unsigned c{0}; c < changed; c++ ) {
+    unsigned const p{args.pos[c]};
+    double const d{-2.0 * args.in[p]};
+    args.in[p] = -args.in[p];
+
+    args.out[0] += d;
+    unsigned j{p};
+    for ( unsigned k{1}; k < h; k++ ) {
+      args.out[k] += d * args.cosine[j];
+      args.out[n - k] -= d * args.sine[j];
+      j += p;
+      if ( j >= n ) j -= n;
+    }
+    args.out[h] += d * args.cosine[j];
+  }
+  return true;
+}
+
 bool check_func(seq const& a, args_t& args)
 {
-  args.assign(a);
+  if ( args.sched && !owned(args) ) return false;
+  count_bracelet();
+
+  if ( args.incremental ) {
+    if ( args.stale < REFRESH && update(a, args) ) {
+      args.stale++;
+      if ( !psd_test(args) ) return false;
+    }
+    else args.assign(a);
+    args.stale = 0;
+  }
+  else args.assign(a);
+
   fftw_execute_r2r(args.plan, args.in, args.out);
   return psd_test(args);
 }
@@ -60,9 +172,356 @@ bool check_func(seq const& a, args_t& args)
 void encounter_func(seq const& a, args_t& args)
 {
   std::size_t i{};
+  std::ostream& os{*args.os};
+
+  if ( args.binary ) {
+    std::fill(args.bits.begin(), args.bits.end(), 0);
+    for ( i = 0; i < args.n; i++ )
+      if ( a[i + 1] == 1 ) args.bits[i >> 6U] |= std::uint64_t{1} << (i & 63U);
+    os.write(reinterpret_cast<char const*>(args.bits.data()),
+             args.bits.size() * sizeof(std::uint64_t));
+    os.write(reinterpret_cast<char const*>(args.psd.data() + 1),
+             (args.n >> 1U) * sizeof(double));
+    return;
+  }
+
   for ( i = 1; i <= args.n; i++ )
-    std::cout << (a[i] == 1 ? -1 : 1) << " ";
-  std::cout << "\t\t";
-  for ( i = 1; i <= (args.n >> 1U); i++ ) std::cout << args.psd[i] << " ";
-  std::cout << '\n' << std::flush;
+    os << (a[i] == 1 ? -1 : 1) << " ";
+  os << "\t\t";
+  for ( i = 1; i <= (args.n >> 1U); i++ ) os << args.psd[i] << " ";
+  os << '\n' << std::flush;
+}
+
+void close_block(args_t& args)
+{
+  if ( !args.active ) return;
+  std::string s{args.buf->str()};
+  args.buf->str({});
+  args.sched->submit(args.block, s);
+  args.active = false;
+}
+
+/**
+ * @brief Writes the usage of the bracelet generating executables.
+ *
+ * Writes the usage of the bracelet generating executables to stderr.
+ *
+ * @param name Name of the executable.
+ * @return bool Always false.
+ */
+static
+bool usage(char const *name)
+{
+  std::cerr << "USAGE -- " << name
+            << " [-j <threads>] [-k] [-b <blocksize>] [-o <file>] [-f text|bin]"
+            << " [-e fft|inc] [-s <k>/<m>] [-c <checkpoint>] <N>\n"
+            << std::flush;
+  return false;
+}
+
+bool parse_opts(int argc, char *argv[], opts_t& opts)
+{
+  static const option longopts[]{
+    {"threads", required_argument, nullptr, 'j'},
+    {"ordered", no_argument, nullptr, 'k'},
+    {"block", required_argument, nullptr, 'b'},
+    {"output", required_argument, nullptr, 'o'},
+    {"format", required_argument, nullptr, 'f'},
+    {"engine", required_argument, nullptr, 'e'},
+    {"shard", required_argument, nullptr, 's'},
+    {"checkpoint", required_argument, nullptr, 'c'},
+    {nullptr, 0, nullptr, 0}
+  };
+
+  int c{};
+  char slash{};
+  while ( (c = getopt_long(argc, argv, "j:kb:o:f:e:s:c:", longopts, nullptr))
+          != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'j': ss >> opts.threads; break;
+    case 'k': opts.ordered = true; break;
+    case 'b': ss >> opts.blocksize; break;
+    case 'o': opts.output = optarg; break;
+    case 'f':
+      if ( std::string{optarg} == "bin" ) opts.binary = true;
+      else if ( std::string{optarg} == "text" ) opts.binary = false;
+      else return usage(argv[0]);
+      break;
+    case 'e':
+      if ( std::string{optarg} == "inc" ) opts.incremental = true;
+      else if ( std::string{optarg} == "fft" ) opts.incremental = false;
+      else return usage(argv[0]);
+      break;
+    case 's':
+      if ( !(ss >> opts.shard >> slash >> opts.shards) || slash != '/' )
+        return usage(argv[0]);
+      break;
+    case 'c': opts.checkpoint = optarg; break;
+    default: return usage(argv[0]);
+    }
+  }
+
+  if ( optind != argc - 1 ) return usage(argv[0]);
+
+  {
+    std::stringstream ss{argv[optind]};
+    ss >> opts.n;
+  }
+
+  if ( opts.n & 1U ) {
+    std::cerr << "ERROR -- parameter <N> must be even\n" << std::flush;
+    return false;
+  }
+  if ( opts.threads == 0 || opts.blocksize == 0 ) {
+    std::cerr << "ERROR -- <threads> and <blocksize> must be positive\n"
+              << std::flush;
+    return false;
+  }
+  if ( opts.binary && opts.output.empty() ) {
+    std::cerr << "ERROR -- binary output requires an output file\n"
+              << std::flush;
+    return false;
+  }
+  if ( opts.shard >= opts.shards ) {
+    std::cerr << "ERROR -- shard <k>/<m> requires 0 <= k < m\n" << std::flush;
+    return false;
+  }
+  if ( !opts.checkpoint.empty() && opts.output.empty() ) {
+    std::cerr << "ERROR -- checkpointing requires an output file\n"
+              << std::flush;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Reads the checkpoint file of an interrupted run.
+ *
+ * Reads the checkpoint file of an interrupted run. The file holds a magic, the
+ * options fixing the partition of the bracelets into blocks and the output
+ * format, the number of blocks written and the number of bytes or, for binary
+ * output, sequences written.
+ *
+ * @post If the file exists and matches the options, the position of the run is
+ * assigned; otherwise nothing is assigned.
+ *
+ * @param opts Options parsed from the command line.
+ * @param found Whether the file exists.
+ * @param block Number of blocks written.
+ * @param written Number of bytes or sequences written.
+ * @return bool True if the file is absent or matches the options; false
+ * otherwise.
+ */
+static
+bool read_checkpoint(opts_t const& opts, bool& found, unsigned long long& block,
+                     unsigned long long& written)
+{
+  std::ifstream is{opts.checkpoint};
+  if ( !(found = bool(is)) ) return true;
+
+  std::string magic;
+  unsigned n{}, shard{}, shards{};
+  unsigned long long blocksize{};
+  bool binary{};
+  is >> magic >> n >> blocksize >> shard >> shards >> binary >> block >> written;
+  if ( !is || magic != "LEGCKPT01" ) {
+    std::cerr << "ERROR -- cannot parse " << opts.checkpoint << '\n'
+              << std::flush;
+    return false;
+  }
+  if ( n != opts.n || blocksize != opts.blocksize || shard != opts.shard ||
+       shards != opts.shards || binary != opts.binary ) {
+    std::cerr << "ERROR -- " << opts.checkpoint
+              << " was written with different options\n" << std::flush;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Writes a file to stable storage.
+ *
+ * Writes a file or directory to stable storage.
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>fsync</li>
+ * </ul>
+ *
+ * @param path Path of the file or directory.
+ * @return bool True on success; false otherwise.
+ */
+static
+bool sync_file(std::string const& path)
+{
+  int fd{::open(path.c_str(), O_RDONLY)};
+  bool ok{fd >= 0 && fsync(fd) == 0};
+  if ( fd >= 0 ) ::close(fd);
+  return ok;
+}
+
+/**
+ * @brief Writes the checkpoint file of a run.
+ *
+ * Writes the checkpoint file of a run. The file is written beside the
+ * checkpoint, written to stable storage and renamed over it, and the directory
+ * holding it is then written to stable storage, so neither an interrupted write
+ * nor a crash leaves a checkpoint other than the previous or the new one.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>sync_file</li>
+ * </ul>
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>std::rename</li>
+ * </ul>
+ *
+ * @pre The output up to the position has been written to stable storage.
+ *
+ * @param opts Options parsed from the command line.
+ * @param block Number of blocks written.
+ * @param written Number of bytes or sequences written.
+ * @return bool True on success; false otherwise.
+ */
+static
+bool write_checkpoint(opts_t const& opts, unsigned long long block,
+                      unsigned long long written)
+{
+  std::string const tmp{opts.checkpoint + ".tmp"};
+  {
+    std::ofstream os{tmp};
+    os << "LEGCKPT01 " << opts.n << " " << opts.blocksize << " " << opts.shard
+       << " " << opts.shards << " " << opts.binary << " " << block << " "
+       << written << '\n';
+    if ( !os.flush() ) {
+      std::cerr << "ERROR -- cannot write " << tmp << '\n' << std::flush;
+      return false;
+    }
+  }
+  if ( !sync_file(tmp) ) {
+    std::cerr << "ERROR -- cannot sync " << tmp << '\n' << std::flush;
+    return false;
+  }
+  if ( std::rename(tmp.c_str(), opts.checkpoint.c_str()) != 0 ) {
+    std::cerr << "ERROR -- cannot write " << opts.checkpoint << '\n'
+              << std::flush;
+    return false;
+  }
+  std::size_t const slash{opts.checkpoint.rfind('/')};
+  std::string const dir{slash == std::string::npos ? "."
+                        : opts.checkpoint.substr(0, slash + 1)};
+  if ( !sync_file(dir) ) {
+    std::cerr << "ERROR -- cannot sync " << dir << '\n' << std::flush;
+    return false;
+  }
+  return true;
+}
+
+bool enumerate(opts_t const& opts,
+               std::function<void(args_t&)> const& traverse)
+{
+  std::ostream *os{&std::cout};
+  std::ofstream file;
+  psdwriter_t W;
+  bool const checkpoint{!opts.checkpoint.empty()};
+  std::string const spill{checkpoint ? opts.checkpoint + ".bits" : ""};
+  bool resumed{};
+  unsigned long long first{}, written{};
+
+  if ( checkpoint && !read_checkpoint(opts, resumed, first, written) )
+    return false;
+
+  if ( opts.binary ) {
+    if ( resumed ? !W.resume(opts.output, opts.n, written, spill)
+         : !W.open(opts.output, opts.n, spill) )
+      return false;
+  }
+  else if ( !opts.output.empty() ) {
+    if ( resumed ) {
+      struct stat st{};
+      if ( stat(opts.output.c_str(), &st) != 0 ||
+           (unsigned long long)(st.st_size) < written ||
+           truncate(opts.output.c_str(), written) != 0 ) {
+        std::cerr << "ERROR -- cannot resume " << opts.output << '\n'
+                  << std::flush;
+        return false;
+      }
+      file.open(opts.output, std::ios::app);
+    }
+    else file.open(opts.output);
+    if ( !file ) {
+      std::cerr << "ERROR -- cannot open " << opts.output << '\n' << std::flush;
+      return false;
+    }
+    os = &file;
+  }
+
+  if ( opts.threads == 1 && !opts.binary && opts.shards == 1 && !checkpoint ) {
+    args_t args{opts.n};
+    args.os = os;
+    args.incremental = opts.incremental;
+    traverse(args);
+    args.destroy();
+    return bool(*os << std::flush);
+  }
+
+  sched_t sched{opts.blocksize, opts.ordered || opts.threads == 1 || checkpoint,
+                [&](std::string& s) {
+                  if ( opts.binary ) W.put_records(s);
+                  else {
+                    *os << s << std::flush;
+                    written += s.size();
+                  }
+                }};
+  sched.stride = opts.shards;
+  sched.offset = opts.shard;
+  sched.skip(first);
+
+  if ( checkpoint ) {
+    sched.progress = [&, last = std::chrono::steady_clock::now(), on = true]
+      (unsigned long long b) mutable {
+      auto const now{std::chrono::steady_clock::now()};
+      if ( !on || now - last < std::chrono::seconds{CHECKPOINT} ) return;
+      last = now;
+      if ( !(opts.binary ? W.sync() : sync_file(opts.output)) ) {
+        std::cerr << "ERROR -- cannot sync " << opts.output << '\n'
+                  << std::flush;
+        on = false;
+      }
+      else on = write_checkpoint(opts, b, opts.binary ? W.count : written);
+      if ( !on )
+        std::cerr << "ERROR -- checkpointing stopped\n" << std::flush;
+    };
+  }
+
+  std::vector<args_t> args;
+  std::vector<std::ostringstream> bufs(opts.threads);
+  args.reserve(opts.threads);
+  for ( unsigned t{0}; t < opts.threads; t++ ) {
+    args.emplace_back(opts.n);
+    args[t].buf = &bufs[t];
+    args[t].os = &bufs[t];
+    args[t].sched = &sched;
+    args[t].binary = opts.binary;
+    args[t].incremental = opts.incremental;
+  }
+
+  run_workers(opts.threads, [&](unsigned t) {
+    traverse(args[t]);
+    close_block(args[t]);
+  });
+  sched.flush();
+
+  for ( auto& x : args ) x.destroy();
+
+  bool const ok{opts.binary ? W.close() : bool(*os << std::flush)};
+  if ( ok && checkpoint ) {
+    std::remove(opts.checkpoint.c_str());
+    std::remove(spill.c_str());
+  }
+  return ok;
 }
@@ -14,9 +14,16 @@
 # ifndef INCLUDED_ARGS_HPP
 # define INCLUDED_ARGS_HPP
 
+# include <cmath>
 # include <iostream>
+# include <sstream>
+# include <functional>
 # include <vector>
 
+# include <psdfile.h++>
+# include <stats.h++>
+# include <workers.h++>
+
 extern "C" {
 # include <fftw3.h>
 }
@@ -103,31 +110,162 @@ struct args_t
    * @post Memory is allocated for the fftw3 input and output arrays.
    * @post The fftw3 plan is allocated and constructed.
    * @post The vector used to house the important psd values is allocated.
+   * @post The vector used to pack sequences for binary output is allocated.
+   * @post The twiddle factors used by the incremental engine are computed.
    *
    * @param _n The length of the bracelets being constructed.
+   * @param flags fftw3 planner flags.
    */
-  explicit args_t(unsigned _n)
-    : n{_n}, bound{(n << 2U) + 4U}, psd((n >> 1U) + 1),
+  explicit args_t(unsigned _n, unsigned flags = FFTW_MEASURE)
+    : n{_n}, bound{(n << 2U) + 4U}, psd((n >> 1U) + 1), bits(psd_words(n)),
       in{(double*)fftw_malloc(sizeof(double) * n)},
       out{(double*)fftw_malloc(sizeof(double) * n)},
-      plan{fftw_plan_r2r_1d(n, in, out, FFTW_R2HC, FFTW_MEASURE)}
-  {}
+      plan{fftw_plan_r2r_1d(n, in, out, FFTW_R2HC, flags)},
+      cosine(n), sine(n), pos(n)
+  {
+    for ( std::size_t j{0}; j < n; j++ ) {
+      cosine[j] = std::cos(2.0 * M_PI * j / n);
+      sine[j] = std::sin(2.0 * M_PI * j / n);
+    }
+    while ( (1U << limit) < n ) limit++;
+  }
 
   ~args_t() = default;
 
   unsigned n{};     ///< length of sequences
   unsigned bound{}; ///< psd bound 2n+2
   psdseq   psd{};   ///< relevant psd values of sequence
+  std::vector<std::uint64_t> bits{}; ///< packed sequence for binary output
 
   double    *in{};   ///< fftw3 input array
   double    *out{};  ///< fftw3 output array
   fftw_plan  plan{}; ///< fftw3 plan used
+
+  bool incremental{};          ///< update the transform of the last bracelet
+  unsigned limit{};            ///< most changed entries updated incrementally
+  unsigned stale{~0U};         ///< incremental updates since last full FFT
+  std::vector<double> cosine{}; ///< cos(2 pi j/n)
+  std::vector<double> sine{};   ///< sin(2 pi j/n)
+  std::vector<unsigned> pos{};  ///< positions changed since the last bracelet
+
+  std::ostream       *os{&std::cout}; ///< stream candidates are written to
+  std::ostringstream *buf{};          ///< output buffer of the current block
+  sched_t            *sched{};        ///< block scheduler; null if unthreaded
+  bool                binary{};       ///< write binary records, see psdfile.h++
+  unsigned long long  count{};        ///< bracelets proposed so far
+  unsigned long long  block{};        ///< index of the current block
+  unsigned long long  begin{};        ///< first bracelet of the current block
+  unsigned long long  end{};          ///< one past last bracelet of the block
+  bool                active{};       ///< whether a block is currently held
+};
+
+/**
+ * @brief Options of the bracelet generating executables.
+ *
+ * Options of the bracelet generating executables A and B.
+ */
+struct opts_t
+{
+  unsigned n{};                       ///< length of sequences
+  unsigned threads{1};                ///< number of worker threads
+  bool ordered{};                     ///< keep the single-threaded order
+  unsigned long long blocksize{4096}; ///< bracelets per block of work
+  std::string output{};               ///< output file; stdout if empty
+  bool binary{};                      ///< write a binary candidate file
+  bool incremental{};                 ///< use the incremental psd engine
+  unsigned shard{};                   ///< index k of the shard run
+  unsigned shards{1};                 ///< number m of shards
+  std::string checkpoint{};           ///< checkpoint file; none if empty
 };
 
+/**
+ * @brief Parses the command line of the bracelet generating executables.
+ *
+ * Parses the command line of the bracelet generating executables. Usage and
+ * errors are written to stderr.
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>getopt</li>
+ * </ul>
+ *
+ * @post On success the options are assigned.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @param opts Options being assigned.
+ * @return bool True if the command line is valid; false otherwise.
+ */
+bool parse_opts(int argc, char *argv[], opts_t& opts);
+
+/**
+ * @brief Runs a bracelet traversal on one or more threads.
+ *
+ * Runs a bracelet traversal on one or more threads. With a single thread, text
+ * output, a single shard and no checkpoint file the traversal is run once on
+ * the output stream. Otherwise each thread runs the traversal with its own
+ * args_t object, but tests only the bracelets lying in the blocks it claims
+ * from a shared sched_t; the output of each block is buffered and written out
+ * by the scheduler. Binary output is passed to a psdwriter_t. All fftw3 plans
+ * are created before the threads are started since fftw3 planning is not
+ * thread-safe.
+ *
+ * Shard k of m tests only the blocks whose index is k modulo m, so m runs with
+ * the same block size test every bracelet exactly once between them. With a
+ * checkpoint file the output is written in block order and, at most every
+ * CHECKPOINT seconds, flushed to stable storage and the number of blocks and
+ * bytes or sequences written are recorded. If the checkpoint file exists the
+ * run resumes from it: the output file is cut back to the recorded size and the
+ * blocks already written are skipped. The checkpoint file is removed once the
+ * run completes.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>run_workers</li>
+ * <li>close_block</li>
+ * <li>read_checkpoint</li>
+ * <li>write_checkpoint</li>
+ * </ul>
+ *
+ * @post The output of every bracelet of the shard passing the psd test is
+ * written to the output file or stdout, in the single-threaded order if
+ * requested.
+ *
+ * @param opts Options parsed from the command line.
+ * @param traverse Function running the bracelet traversal on an args_t object.
+ * @return bool True if the output was written; false otherwise.
+ */
+bool enumerate(opts_t const& opts,
+               std::function<void(args_t&)> const& traverse);
+
+/**
+ * @brief Hands the current block of a worker back to its scheduler.
+ *
+ * Hands the current block of a worker back to its scheduler.
+ *
+ * @pre The args_t object has a scheduler.
+ *
+ * @post The buffered output of the block held, if any, is submitted and the
+ * buffer is emptied.
+ *
+ * @param args Arguments used in bracelet generating routines.
+ */
+void close_block(args_t& args);
+
 /**
  * @brief Function used to implement the psd test.
  *
- * Function used to implement the psd test.
+ * Function used to implement the psd test. If the args_t object has a scheduler,
+ * bracelets outside the blocks claimed by the worker are rejected without being
+ * tested.
+ *
+ * With the incremental engine the transform of the previous bracelet is kept in
+ * the fftw3 output array and only the entries that changed are applied to it,
+ * each at the cost of n/2 twiddle multiplications; consecutive bracelets mostly
+ * differ in a short suffix. A full FFT is run instead when too many entries
+ * changed or after a fixed number of updates, to bound the rounding error. A
+ * bracelet passing the screen is retested with a full FFT, so the output is the
+ * same as with the reference engine.
  *
  * <strong>External Called Functions:</strong>
  * <ul>
@@ -137,6 +275,7 @@ struct args_t
  * <strong>Internal Called Functions:</strong>
  * <ul>
  * <li>args_t::assign -- maps sequence to fftw3 input array</li>
+ * <li>update -- applies the changed entries to the fftw3 output array</li>
  * <li>psd_test -- uses outout of fftw_execute_r2r to do psd test</li>
  * </ul>
  *
@@ -158,12 +297,13 @@ bool check_func(seq const& a, args_t& args);
 /**
  * @brief Prints sequence if it passes the psd test.
  *
- * Prints sequence if it passes the psd test.
+ * Prints sequence if it passes the psd test. In binary mode a record holding
+ * the packed sequence followed by its psd values is written instead.
  *
  * @pre Sequence a has first element 0 and remaining elements +1 or -1.
  * @pre args_t object created, and internal fftw3 objects are allocated.
  *
- * @post Sequence is mapped to stdout.
+ * @post Sequence is mapped to the output stream of the args_t object.
  *
  * @param a Sequence constructed from bracelet routine.
  * @param args Arguments used in bracelet generating routines.
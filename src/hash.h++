@@ -0,0 +1,55 @@
+/**
+ * @file hash.h++
+ * @brief Linear hash of integer vectors shared by whiteman and amicable.
+ *
+ * Linear hash of integer vectors shared by whiteman and amicable. The hash of a
+ * vector v is the sum of v[k] R[k] modulo 2^64 for fixed odd multipliers R[k],
+ * so the hash of a sum or a negation of vectors is the sum or negation of their
+ * hashes. Equal hashes do not imply equal vectors; hits have to be verified.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_HASH_HPP
+# define INCLUDED_HASH_HPP
+
+# include <cstdint>
+
+/**
+ * @brief Multiplier of the hash at a given index.
+ *
+ * Multiplier of the hash at a given index. The multipliers are odd values taken
+ * from the splitmix64 generator with a fixed seed.
+ *
+ * @param k Index.
+ * @return Multiplier.
+ */
+static inline
+std::uint64_t multiplier(unsigned k)
+{
+  std::uint64_t z{0x9e3779b97f4a7c15ULL * (k + 1)};
+  z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31U)) | 1U;
+}
+
+/**
+ * @brief Hash of an integer vector.
+ *
+ * Hash of an integer vector.
+ *
+ * @param p Vector.
+ * @param len Length of vector.
+ * @return Hash.
+ */
+static inline
+std::uint64_t linear_hash(int const *p, unsigned len)
+{
+  std::uint64_t h{0};
+  for ( unsigned k{0}; k < len; k++ )
+    h += std::uint64_t(std::int64_t(p[k])) * multiplier(k);
+  return h;
+}
+
+# endif
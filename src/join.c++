@@ -0,0 +1,133 @@
+/**
+ * @file join.c++
+ * @brief Implementation of the hash join used by whiteman.
+ *
+ * Implementation of the hash join used by whiteman.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <algorithm>
+
+# include <join.h++>
+
+/**
+ * @brief Computes the autocorrelations and hashes of a range of sequences.
+ *
+ * Computes the autocorrelations and hashes of a range of sequences. The length N
+ * is a compile-time constant unless zero, in which case the loops over the
+ * sequence use the runtime length.
+ *
+ * @param F Table of sequences.
+ * @param lo First sequence.
+ * @param hi One past the last sequence.
+ * @param P Table being filled.
+ */
+template <unsigned N>
+static
+void pafs(psdfile_t const& F, std::size_t lo, std::size_t hi, paftab_t& P)
+{
+  unsigned const n{extent<N>(F.n)}, len{P.len};
+  std::vector<int> a(2 * n);
+  for ( std::size_t i{lo}; i < hi; i++ ) {
+    for ( std::size_t j{0}; j < n; j++ ) a[j] = a[j + n] = F.at(i, j);
+
+    int *p{P.paf.data() + i * len};
+    for ( unsigned k{1}; k <= len; k++ ) {
+      int sum{0};
+      if constexpr ( N != 0 )
+        unroll<N>([&](std::size_t j) {sum += a[j] * a[j + k];});
+      else
+        for ( std::size_t j{0}; j < n; j++ ) sum += a[j] * a[j + k];
+      p[k - 1] = sum;
+    }
+    P.key[i] = linear_hash(p, len);
+  }
+}
+
+paftab_t::paftab_t(psdfile_t const& F, unsigned threads)
+  : len{F.len}, paf(F.count * F.len), key(F.count)
+{
+  dispatch(F.n, [&](auto N) {
+    parallel_for(threads, F.count, [&](std::size_t lo, std::size_t hi) {
+      pafs<decltype(N)::value>(F, lo, hi, *this);
+    });
+  });
+}
+
+join_t::join_t(psdfile_t const& _A, psdfile_t const& _B, unsigned threads)
+  : A{_A}, B{_B}, PA{_A, threads}, PB{_B, threads}
+{
+  std::size_t const numA{A.count};
+  std::vector<std::vector<pair_t>> parts(threads);
+
+  run_workers(threads, [&](unsigned t) {
+    std::vector<pair_t>& part{parts[t]};
+    for ( std::size_t j1{t}; j1 < numA; j1 += threads )
+      for ( std::size_t j2{j1}; j2 < numA; j2++ )
+        if ( within_bound(sequence_t{A, j1}, sequence_t{A, j2}) )
+          part.push_back({PA.key[j1] + PA.key[j2],
+                          std::uint32_t(j1), std::uint32_t(j2)});
+  });
+
+  std::vector<std::size_t> offset(threads + 1, 0);
+  for ( unsigned t{0}; t < threads; t++ )
+    offset[t + 1] = offset[t] + parts[t].size();
+  index.resize(offset[threads]);
+  run_workers(threads, [&](unsigned t) {
+    std::copy(parts[t].begin(), parts[t].end(), index.begin() + offset[t]);
+    std::vector<pair_t>{}.swap(parts[t]);
+  });
+  parallel_sort(threads, index, std::less<pair_t>{});
+
+  std::vector<int> target(A.len, -4);
+  key = linear_hash(target.data(), A.len);
+}
+
+/**
+ * @brief Searches the rows i1 in [lo, hi) of a hash join.
+ *
+ * Searches the rows i1 in [lo, hi) of a hash join. The number H of
+ * autocorrelations is a compile-time constant unless zero.
+ *
+ * @param J Hash join.
+ * @param lo First row.
+ * @param hi One past the last row.
+ * @param os std::ostream object.
+ */
+template <unsigned H>
+static
+void rows(join_t const& J, std::size_t lo, std::size_t hi, std::ostream& os)
+{
+  psdfile_t const& A{J.A};
+  psdfile_t const& B{J.B};
+  unsigned const len{extent<H>(A.len)};
+  std::size_t i1{}, i2{};
+
+  for ( i1 = lo; i1 < hi; i1++ )
+    for ( i2 = 0; i2 < B.count; i2++ ) {
+      sequence_t const s1{A, i1}, s4{B, i2};
+      if ( !check_bound<H>(s1, s4) ) continue;
+
+      pair_t const first{J.key - J.PA.key[i1] - J.PB.key[i2],
+                         std::uint32_t(i1), 0};
+      for ( auto it{std::lower_bound(J.index.begin(), J.index.end(), first)};
+            it != J.index.end() && it->key == first.key; it++ ) {
+        int const *p1{J.PA[i1]}, *p2{J.PA[it->j1]}, *p3{J.PA[it->j2]};
+        int const *p4{J.PB[i2]};
+        unsigned k{0};
+        while ( k < len && p1[k] + p2[k] + p3[k] + p4[k] == -4 ) k++;
+        if ( k < len ) continue;
+
+        pr(os, s1, sequence_t{A, it->j1}, sequence_t{A, it->j2}, s4);
+      }
+    }
+}
+
+void join_t::rows(std::size_t lo, std::size_t hi, std::ostream& os) const
+{
+  dispatch(A.n, [&](auto N) {
+    ::rows<decltype(N)::value / 2>(*this, lo, hi, os);
+  });
+}
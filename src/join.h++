@@ -0,0 +1,156 @@
+/**
+ * @file join.h++
+ * @brief Interface for the hash join used by whiteman.
+ *
+ * Interface for the hash join used by whiteman. Four sequences of length n have
+ * power spectral densities summing to 4n+4 at every nonzero frequency exactly
+ * when their out-of-phase periodic autocorrelations sum to -4 at every lag. The
+ * autocorrelations are integers and so serve as exact keys: the pairs of
+ * sequences of the first type are indexed by the sum of their autocorrelations,
+ * and for every pair of a sequence of each type the complementing pair is looked
+ * up in the index.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_JOIN_HPP
+# define INCLUDED_JOIN_HPP
+
+# include <cstdint>
+# include <vector>
+
+# include <hash.h++>
+# include <sequence.h++>
+# include <workers.h++>
+
+/**
+ * @brief Table of the autocorrelations of the sequences of a psdfile_t table.
+ *
+ * Table of the autocorrelations of the sequences of a psdfile_t table, lags 1 to
+ * n/2, together with their linear hash; see hash.h++. The hash of a sum of
+ * autocorrelation vectors is the sum of their hashes.
+ */
+struct paftab_t
+{
+  /**
+   * @brief Autocorrelations of a sequence.
+   *
+   * Autocorrelations of a sequence.
+   *
+   * @param i Index of sequence.
+   * @return Pointer to the len autocorrelations at lags 1 to n/2.
+   */
+  int const *operator[](std::size_t i) const {return paf.data() + i * len;}
+
+  paftab_t& operator=(paftab_t const&) & = default;
+  paftab_t& operator=(paftab_t &&) & noexcept = default;
+
+  paftab_t() = default;
+  paftab_t(paftab_t const&) = default;
+  paftab_t(paftab_t &&) noexcept = default;
+
+  /**
+   * @brief Standard constructor.
+   *
+   * Standard constructor. Computes the autocorrelations and hashes of every
+   * sequence of the table on the given number of threads.
+   *
+   * @param F Table of sequences.
+   * @param threads Number of threads.
+   */
+  explicit paftab_t(psdfile_t const& F, unsigned threads = 1);
+
+  ~paftab_t() = default;
+
+  unsigned len{};                  ///< number of lags
+  buffer_t<int> paf{};             ///< autocorrelations, len per sequence
+  buffer_t<std::uint64_t> key{};   ///< hash of the autocorrelations
+};
+
+/**
+ * @brief Entry of the index of pairs of sequences of the first type.
+ *
+ * Entry of the index of pairs of sequences of the first type.
+ */
+struct pair_t
+{
+  friend auto operator<=>(pair_t const&, pair_t const&) = default;
+
+  std::uint64_t key; ///< hash of the summed autocorrelations
+  std::uint32_t j1;  ///< first sequence of the pair
+  std::uint32_t j2;  ///< second sequence of the pair, j1 <= j2
+};
+
+/**
+ * @brief Hash join finding the 4-sets with sequences of the given types.
+ *
+ * Hash join finding the 4-sets with sequences of the given types. Every pair
+ * j1 <= j2 of sequences of the first type passing the psd test is indexed by the
+ * hash of its summed autocorrelations. Then for every i1 and i2 the complement
+ * of the autocorrelations of the first sequence of the first type and the
+ * sequence of the second type is looked up, keeping the pairs with i1 <= j1, and
+ * each hit is verified exactly before being printed. The index is read-only once
+ * built, so rows i1 may be searched concurrently.
+ */
+struct join_t
+{
+  /**
+   * @brief Searches the rows i1 in [lo, hi).
+   *
+   * Searches the rows i1 in [lo, hi).
+   *
+   * <strong>Internal Called Functions:</strong>
+   * <ul>
+   * <li>check_bound</li>
+   * <li>pr</li>
+   * </ul>
+   *
+   * @post Every 4-set (i1, j1, j2, i2) with lo <= i1 < hi and i1 <= j1 <= j2
+   * whose autocorrelations sum to -4 is printed, in order of i1, i2, j1, j2.
+   *
+   * @param lo First row.
+   * @param hi One past the last row.
+   * @param os std::ostream object.
+   */
+  void rows(std::size_t lo, std::size_t hi, std::ostream& os) const;
+
+  join_t& operator=(join_t const&) & = delete;
+  join_t& operator=(join_t &&) & = delete;
+
+  join_t() = delete;
+  join_t(join_t const&) = delete;
+  join_t(join_t &&) = delete;
+
+  /**
+   * @brief Standard constructor.
+   *
+   * Standard constructor. Computes the autocorrelation tables and builds the
+   * index of pairs on the given number of threads.
+   *
+   * <strong>Internal Called Functions:</strong>
+   * <ul>
+   * <li>run_workers</li>
+   * <li>within_bound</li>
+   * <li>parallel_sort</li>
+   * </ul>
+   *
+   * @pre Both tables hold sequences of the same length.
+   *
+   * @param _A Table of sequences of the first type.
+   * @param _B Table of sequences of the second type.
+   * @param threads Number of threads.
+   */
+  join_t(psdfile_t const& _A, psdfile_t const& _B, unsigned threads = 1);
+
+  ~join_t() = default;
+
+  psdfile_t const& A;          ///< sequences of the first type
+  psdfile_t const& B;          ///< sequences of the second type
+  paftab_t PA{};               ///< autocorrelations of the first type
+  paftab_t PB{};               ///< autocorrelations of the second type
+  buffer_t<pair_t> index{};    ///< pairs of the first type sorted by key
+  std::uint64_t key{};         ///< hash of the target autocorrelations
+};
+
+# endif
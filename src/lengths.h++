@@ -0,0 +1,92 @@
+/**
+ * @file lengths.h++
+ * @brief Table of sequence lengths with compile-time specialized kernels.
+ *
+ * Table of sequence lengths with compile-time specialized kernels. The kernels of
+ * whiteman are templates on the length N; a length read at runtime is mapped to
+ * its instantiation by dispatch, and lengths not in the table fall back to the
+ * instantiation N = 0, which uses the runtime length. With N known the
+ * autocorrelation loops are unrolled completely by unroll, and the bound checks
+ * and the two-pointer walk run with constant trip counts; the bound checks keep
+ * their early exits, since most pairs fail on their first values.
+ *
+ * The table is set by the macro LEGENDRE_LENGTHS, e.g.
+ * CPPFLAGS='-DLEGENDRE_LENGTHS=58,62,66'.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_LENGTHS_HPP
+# define INCLUDED_LENGTHS_HPP
+
+# include <array>
+# include <cstddef>
+# include <type_traits>
+# include <utility>
+
+# ifndef LEGENDRE_LENGTHS
+# define LEGENDRE_LENGTHS 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, \
+    32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62, 64
+# endif
+
+/**
+ * @brief Even lengths with specialized kernels.
+ */
+inline constexpr unsigned lengths[]{LEGENDRE_LENGTHS};
+
+/**
+ * @brief Length used by a kernel.
+ *
+ * Length used by a kernel: the template parameter if nonzero, otherwise the
+ * runtime value.
+ *
+ * @param rt Runtime value.
+ * @return Length.
+ */
+template <unsigned N>
+constexpr unsigned extent(unsigned rt)
+{
+  if constexpr ( N != 0 ) return N;
+  else return rt;
+}
+
+/**
+ * @brief Calls a function with the compile-time constant matching a length.
+ *
+ * Calls a function with the compile-time constant matching a length. The
+ * function is called with std::integral_constant<unsigned, N> for N the length
+ * if it is in the table, and N = 0 otherwise.
+ *
+ * @param n Length.
+ * @param f Function being called; all instantiations must return the same type.
+ * @return Value returned by the function.
+ */
+template <std::size_t I = 0, typename F>
+decltype(auto) dispatch(unsigned n, F&& f)
+{
+  if constexpr ( I == std::size(lengths) )
+    return f(std::integral_constant<unsigned, 0>{});
+  else {
+    if ( n == lengths[I] )
+      return f(std::integral_constant<unsigned, lengths[I]>{});
+    return dispatch<I + 1>(n, std::forward<F>(f));
+  }
+}
+
+/**
+ * @brief Calls a function for every index below N, unrolled.
+ *
+ * Calls a function for every index below N, unrolled.
+ *
+ * @param f Function called with each index.
+ */
+template <std::size_t N, typename F>
+constexpr void unroll(F&& f)
+{
+  [&]<std::size_t... K>(std::index_sequence<K...>) {
+    (f(K), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+# endif
@@ -0,0 +1,70 @@
+/**
+ * @file psdconv.c++
+ * @brief File to generate executable converting candidate files between the text
+ * and binary formats.
+ *
+ * File to generate executable converting candidate files between the text and
+ * binary formats. A text file, as written by A and B, is converted to a binary
+ * candidate file and a binary candidate file is converted to text; see
+ * psdfile.h++.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./psdconv [-s] infile outfile</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-s --</strong> sort the sequences by psd, as done by whiteman;
+ * a sorted binary file is read by whiteman without copying</li>
+ * <li><strong>infile --</strong> file being converted</li>
+ * <li><strong>outfile --</strong> converted file; - writes text to stdout and
+ * is only accepted for a binary infile</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <fstream>
+# include <iostream>
+# include <string>
+
+# include <psdfile.h++>
+
+int main(int argc, char *argv[])
+{
+  bool sort{argc > 1 && std::string{argv[1]} == "-s"};
+  if ( argc != 3 + sort ) {
+    std::cerr << "USAGE -- ./psdconv [-s] <infile> <outfile>\n" << std::flush;
+    return 1;
+  }
+
+  std::string in{argv[1 + sort]}, out{argv[2 + sort]};
+
+  psdfile_t F;
+  if ( !F.load(in) ) return 1;
+  bool binary{F.map != nullptr};
+  if ( sort ) F.sort();
+
+  if ( !binary ) {
+    if ( out == "-" ) {
+      std::cerr << "ERROR -- a binary file cannot be written to stdout\n"
+                << std::flush;
+      return 1;
+    }
+    return F.write(out) ? 0 : 1;
+  }
+
+  if ( out == "-" ) {
+    F.write_text(std::cout);
+    return std::cout.flush() ? 0 : 1;
+  }
+
+  std::ofstream os{out};
+  F.write_text(os);
+  if ( !os.flush() ) {
+    std::cerr << "ERROR -- cannot write " << out << '\n' << std::flush;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,400 @@
+/**
+ * @file psdfile.c++
+ * @brief Implementation of the binary psd candidate file shared by A, B and
+ * whiteman.
+ *
+ * Implementation of the binary psd candidate file shared by A, B and whiteman.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <algorithm>
+# include <atomic>
+# include <cstdlib>
+# include <cstring>
+# include <fstream>
+# include <iterator>
+# include <numeric>
+
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
+# include <psdfile.h++>
+
+static const char MAGIC[8]{'L', 'E', 'G', 'P', 'S', 'D', '0', '1'};
+
+/**
+ * @brief Maps a binary candidate file.
+ *
+ * Maps a binary candidate file.
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>mmap</li>
+ * </ul>
+ *
+ * @pre The file descriptor is open for reading and the file starts with the
+ * magic.
+ *
+ * @post On success the table views the mapped file.
+ *
+ * @param F Table being loaded.
+ * @param fd File descriptor.
+ * @param size Size of the file.
+ * @param path Path of the file, used in error messages.
+ * @return bool True on success; false otherwise.
+ */
+static
+bool map_file(psdfile_t& F, int fd, std::size_t size, std::string const& path)
+{
+  void *p{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+  if ( p == MAP_FAILED ) {
+    std::cerr << "ERROR -- cannot map " << path << '\n' << std::flush;
+    return false;
+  }
+  F.map = p;
+  F.mapsize = size;
+
+  psdhdr_t const& h{*static_cast<psdhdr_t const*>(p)};
+  F.n = h.n;
+  F.len = h.len;
+  F.words = h.words;
+  F.count = h.count;
+  F.sorted = h.sorted;
+
+  if ( F.words != psd_words(F.n) ||
+       size != sizeof(psdhdr_t) +
+       F.count * (F.len * sizeof(double) + F.words * sizeof(std::uint64_t)) ) {
+    std::cerr << "ERROR -- " << path << " is truncated or corrupt\n"
+              << std::flush;
+    return false;
+  }
+
+  char const *base{static_cast<char const*>(p) + sizeof(psdhdr_t)};
+  F.psd = reinterpret_cast<double const*>(base);
+  F.bits = reinterpret_cast<std::uint64_t const*>
+    (base + F.count * F.len * sizeof(double));
+  madvise(p, size, MADV_WILLNEED);
+
+  return true;
+}
+
+bool psdfile_t::load(std::string const& path, unsigned threads)
+{
+  int fd{::open(path.c_str(), O_RDONLY)};
+  if ( fd < 0 ) {
+    std::cerr << "ERROR -- cannot open " << path << '\n' << std::flush;
+    return false;
+  }
+
+  struct stat st{};
+  fstat(fd, &st);
+  std::size_t size = st.st_size;
+
+  char magic[sizeof(MAGIC)]{};
+  bool binary{size >= sizeof(psdhdr_t) &&
+              ::read(fd, magic, sizeof(magic)) == sizeof(magic) &&
+              std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0};
+
+  bool ok{};
+  if ( binary ) ok = map_file(*this, fd, size, path);
+  ::close(fd);
+  if ( binary ) return ok;
+
+  std::ifstream is{path};
+  std::string text{std::istreambuf_iterator<char>{is},
+                   std::istreambuf_iterator<char>{}};
+  if ( !parse(text, threads) ) {
+    std::cerr << "ERROR -- cannot parse " << path << '\n' << std::flush;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Parses one line of the text format.
+ *
+ * Parses one line of the text format.
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>std::strtol</li>
+ * <li>std::strtod</li>
+ * </ul>
+ *
+ * @pre The line is followed by a newline or the terminating null character.
+ *
+ * @post The packed sequence and the psd values are written.
+ *
+ * @param p Start of the line.
+ * @param e End of the line.
+ * @param n Length of sequence.
+ * @param b Packed sequence, zeroed.
+ * @param psd psd values, n/2 of them.
+ * @return bool True if the line holds n entries +1 or -1 and n/2 values; false
+ * otherwise.
+ */
+static
+bool parse_line(char const *p, char const *e, unsigned n, std::uint64_t *b,
+                double *psd)
+{
+  char *q{};
+  for ( unsigned j{0}; j < n; j++ ) {
+    long x{std::strtol(p, &q, 10)};
+    if ( q == p || q > e || (x != 1 && x != -1) ) return false;
+    if ( x == -1 ) b[j >> 6U] |= std::uint64_t{1} << (j & 63U);
+    p = q;
+  }
+  for ( unsigned j{0}; j < (n >> 1U); j++ ) {
+    psd[j] = std::strtod(p, &q);
+    if ( q == p || q > e ) return false;
+    p = q;
+  }
+  return true;
+}
+
+bool psdfile_t::parse(std::string const& text, unsigned threads)
+{
+  std::vector<char const*> L;
+  char const *p{text.data()}, *e{text.data() + text.size()};
+  while ( p < e ) {
+    char const *q{static_cast<char const*>(std::memchr(p, '\n', e - p))};
+    if ( !q ) q = e;
+    if ( q != p ) L.push_back(p);
+    p = q + 1;
+  }
+  if ( L.empty() ) return true;
+
+  {
+    char const *q{L[0]};
+    char *r{};
+    n = 0;
+    while ( *q != '\t' && *q != '\n' && *q != '\0' ) {
+      std::strtol(q, &r, 10);
+      if ( r == q ) break;
+      n++;
+      q = r;
+      while ( *q == ' ' ) q++;
+    }
+  }
+  len = n >> 1U;
+  words = psd_words(n);
+  count = L.size();
+
+  psdbuf.clear();
+  bitbuf.clear();
+  psdbuf.resize(count * len);
+  bitbuf.resize(count * words);
+  std::atomic<bool> ok{true};
+  parallel_for(threads, count, [&](std::size_t lo, std::size_t hi) {
+    for ( std::size_t i{lo}; i < hi; i++ ) {
+      char const *end{i + 1 < count ? L[i + 1] : e};
+      std::fill_n(bitbuf.data() + i * words, words, 0);
+      if ( !parse_line(L[i], end, n, bitbuf.data() + i * words,
+                       psdbuf.data() + i * len) )
+        ok = false;
+    }
+  });
+
+  psd = psdbuf.data();
+  bits = bitbuf.data();
+  sorted = false;
+  return ok;
+}
+
+bool psdfile_t::append(psdfile_t const& G)
+{
+  if ( G.count == 0 ) return true;
+  if ( count == 0 ) {
+    n = G.n;
+    len = G.len;
+    words = G.words;
+  }
+  else if ( G.n != n ) return false;
+
+  psdbuf.insert(psdbuf.end(), G.psd, G.psd + G.count * len);
+  bitbuf.insert(bitbuf.end(), G.bits, G.bits + G.count * words);
+  count += G.count;
+  psd = psdbuf.data();
+  bits = bitbuf.data();
+  sorted = false;
+  return true;
+}
+
+void psdfile_t::sort(unsigned threads)
+{
+  if ( sorted ) return;
+
+  std::vector<std::size_t> I(count);
+  std::iota(I.begin(), I.end(), 0);
+  auto cmp = [this](std::size_t i, std::size_t j) {
+    return std::lexicographical_compare(psd + i * len, psd + (i + 1) * len,
+                                        psd + j * len, psd + (j + 1) * len);
+  };
+  std::sort(I.begin(), I.end(), cmp);
+
+  buffer_t<double> P(count * len);
+  buffer_t<std::uint64_t> B(count * words);
+  parallel_for(threads, count, [&](std::size_t lo, std::size_t hi) {
+    for ( std::size_t i{lo}; i < hi; i++ ) {
+      std::copy(psd + I[i] * len, psd + (I[i] + 1) * len, P.begin() + i * len);
+      std::copy(bits + I[i] * words, bits + (I[i] + 1) * words,
+                B.begin() + i * words);
+    }
+  });
+
+  psdbuf = std::move(P);
+  bitbuf = std::move(B);
+  psd = psdbuf.data();
+  bits = bitbuf.data();
+  sorted = true;
+
+  if ( map ) {
+    munmap(map, mapsize);
+    map = nullptr;
+    mapsize = 0;
+  }
+}
+
+bool psdfile_t::write(std::string const& path) const
+{
+  psdwriter_t W;
+  if ( !W.open(path, n) ) return false;
+  for ( std::size_t i{0}; i < count; i++ )
+    W.put(bits + i * words, psd + i * len);
+  W.sorted = sorted;
+  return W.close();
+}
+
+void psdfile_t::write_text(std::ostream& os) const
+{
+  std::size_t i{}, j{};
+  for ( i = 0; i < count; i++ ) {
+    for ( j = 0; j < n; j++ ) os << at(i, j) << " ";
+    os << "\t\t";
+    for ( j = 0; j < len; j++ ) os << psd[i * len + j] << " ";
+    os << '\n';
+  }
+}
+
+psdfile_t::~psdfile_t()
+{
+  if ( map ) munmap(map, mapsize);
+}
+
+bool psdwriter_t::open(std::string const& path, unsigned _n,
+                       std::string const& spill)
+{
+  n = _n;
+  len = n >> 1U;
+  words = psd_words(n);
+  count = 0;
+  spilled = 0;
+  sorted = false;
+  bits.clear();
+
+  F = std::fopen(path.c_str(), "wb");
+  if ( !F ) {
+    std::cerr << "ERROR -- cannot open " << path << '\n' << std::flush;
+    return false;
+  }
+  if ( !spill.empty() && !(S = std::fopen(spill.c_str(), "wb")) ) {
+    std::cerr << "ERROR -- cannot open " << spill << '\n' << std::flush;
+    return false;
+  }
+
+  psdhdr_t h{};
+  std::fwrite(&h, sizeof(h), 1, F);
+  return true;
+}
+
+bool psdwriter_t::resume(std::string const& path, unsigned _n,
+                         std::size_t _count, std::string const& spill)
+{
+  n = _n;
+  len = n >> 1U;
+  words = psd_words(n);
+  count = spilled = _count;
+  sorted = false;
+  bits.assign(count * words, 0);
+
+  F = std::fopen(path.c_str(), "r+b");
+  S = std::fopen(spill.c_str(), "r+b");
+  long const size = sizeof(psdhdr_t) + count * len * sizeof(double);
+  bool ok{F && S &&
+          std::fread(bits.data(), sizeof(std::uint64_t), bits.size(), S) ==
+          bits.size() &&
+          std::fseek(F, 0, SEEK_END) == 0 && std::ftell(F) >= size &&
+          ftruncate(fileno(F), size) == 0 &&
+          ftruncate(fileno(S), bits.size() * sizeof(std::uint64_t)) == 0 &&
+          std::fseek(F, size, SEEK_SET) == 0 &&
+          std::fseek(S, 0, SEEK_END) == 0};
+  if ( !ok ) {
+    std::cerr << "ERROR -- cannot resume " << path << '\n' << std::flush;
+    if ( F ) std::fclose(F);
+    if ( S ) std::fclose(S);
+    F = S = nullptr;
+  }
+  return ok;
+}
+
+bool psdwriter_t::sync()
+{
+  std::fwrite(bits.data() + spilled * words, sizeof(std::uint64_t),
+              (count - spilled) * words, S);
+  spilled = count;
+
+  bool ok{std::fflush(F) == 0 && std::fflush(S) == 0 &&
+          fsync(fileno(F)) == 0 && fsync(fileno(S)) == 0};
+  if ( !ok ) std::cerr << "ERROR -- cannot sync candidate file\n" << std::flush;
+  return ok;
+}
+
+void psdwriter_t::put(std::uint64_t const *b, double const *p)
+{
+  std::fwrite(p, sizeof(double), len, F);
+  bits.insert(bits.end(), b, b + words);
+  count++;
+}
+
+void psdwriter_t::put_records(std::string const& s)
+{
+  std::size_t rec{words * sizeof(std::uint64_t) + len * sizeof(double)};
+  std::vector<std::uint64_t> b(words);
+  std::vector<double> p(len);
+  for ( std::size_t i{0}; i + rec <= s.size(); i += rec ) {
+    std::memcpy(b.data(), s.data() + i, words * sizeof(std::uint64_t));
+    std::memcpy(p.data(), s.data() + i + words * sizeof(std::uint64_t),
+                len * sizeof(double));
+    put(b.data(), p.data());
+  }
+}
+
+bool psdwriter_t::close()
+{
+  if ( !F ) return false;
+
+  std::fwrite(bits.data(), sizeof(std::uint64_t), bits.size(), F);
+
+  psdhdr_t h{};
+  std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.n = n;
+  h.len = len;
+  h.count = count;
+  h.sorted = sorted;
+  h.words = words;
+
+  bool ok{std::fseek(F, 0, SEEK_SET) == 0 &&
+          std::fwrite(&h, sizeof(h), 1, F) == 1};
+  ok = (std::fclose(F) == 0) && ok;
+  F = nullptr;
+  if ( S ) std::fclose(S);
+  S = nullptr;
+  bits.clear();
+
+  if ( !ok ) std::cerr << "ERROR -- cannot write candidate file\n" << std::flush;
+  return ok;
+}
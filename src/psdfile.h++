@@ -0,0 +1,329 @@
+/**
+ * @file psdfile.h++
+ * @brief Interface for the binary psd candidate file shared by A, B and whiteman.
+ *
+ * Interface for the binary psd candidate file shared by A, B and whiteman. A file
+ * consists of a header, followed by the psd values of every sequence stored
+ * contiguously, followed by the bit-packed sequences. A set bit stands for an
+ * entry -1 and a clear bit for an entry +1. Values are stored in the byte order
+ * of the machine writing the file.
+ *
+ * <dl>
+ * <dt><strong>Layout</strong></dt>
+ * <dd>psdhdr_t | double psd[count][len] | uint64_t bits[count][words]</dd>
+ * </dl>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_PSDFILE_HPP
+# define INCLUDED_PSDFILE_HPP
+
+# include <cstdint>
+# include <cstdio>
+# include <iostream>
+# include <string>
+# include <vector>
+
+# include <workers.h++>
+
+/**
+ * @brief Header of a binary psd candidate file.
+ *
+ * Header of a binary psd candidate file.
+ */
+struct psdhdr_t
+{
+  char          magic[8]; ///< file identifier "LEGPSD01"
+  std::uint32_t n;        ///< length of sequences
+  std::uint32_t len;      ///< psd values per sequence
+  std::uint64_t count;    ///< number of sequences
+  std::uint32_t sorted;   ///< nonzero if sorted lexicographically by psd
+  std::uint32_t words;    ///< 64-bit words per packed sequence
+};
+
+/**
+ * @brief Number of 64-bit words holding a packed sequence of length n.
+ *
+ * Number of 64-bit words holding a packed sequence of length n.
+ *
+ * @param n Length of sequence.
+ * @return Number of words.
+ */
+static inline
+unsigned psd_words(unsigned n)
+{
+  return (n + 63U) >> 6U;
+}
+
+/**
+ * @brief Table of sequences and their psd values.
+ *
+ * Table of sequences and their psd values. A binary file is memory mapped and
+ * read in place; a text file, in the format written by A and B, is parsed into
+ * buffers owned by the table. Sorting a table which is not already sorted builds
+ * a sorted copy in owned buffers.
+ */
+struct psdfile_t
+{
+  /**
+   * @brief Loads a binary or text candidate file.
+   *
+   * Loads a binary or text candidate file. The format is decided by the magic of
+   * the file. A text file is parsed on the given number of threads.
+   *
+   * <strong>External Called Functions:</strong>
+   * <ul>
+   * <li>mmap</li>
+   * </ul>
+   *
+   * @post On success the table views the sequences of the file. On failure an
+   * error is written to stderr.
+   *
+   * @param path Path of the file.
+   * @param threads Number of threads.
+   * @return bool True on success; false otherwise.
+   */
+  bool load(std::string const& path, unsigned threads = 1);
+
+  /**
+   * @brief Parses candidates in the text format written by A and B.
+   *
+   * Parses candidates in the text format written by A and B: the n entries +1 or
+   * -1 of a sequence, two tabs, and its n/2 psd values, one sequence per line.
+   * The length n is taken from the first line. The lines are split between the
+   * given number of threads.
+   *
+   * @post The table holds the parsed sequences in owned buffers.
+   *
+   * @param text Contents of the file.
+   * @param threads Number of threads.
+   * @return bool True on success; false otherwise.
+   */
+  bool parse(std::string const& text, unsigned threads = 1);
+
+  /**
+   * @brief Appends the sequences of another table.
+   *
+   * Appends the sequences of another table, copying them into buffers owned by
+   * the table.
+   *
+   * @pre The table is not mapped.
+   *
+   * @post The sequences of the other table follow those of the table, which is
+   * no longer marked as sorted.
+   *
+   * @param G Table being appended.
+   * @return bool True if both tables hold sequences of the same length or
+   * either is empty; false otherwise.
+   */
+  bool append(psdfile_t const& G);
+
+  /**
+   * @brief Sorts the table lexicographically by psd.
+   *
+   * Sorts the table lexicographically by psd. The permutation is found by
+   * std::sort on one thread, so sequences with equal psd come out in the same
+   * order for any number of threads and as in earlier versions of whiteman,
+   * whose two-pointer walk depends on that order; the sequences are then copied
+   * into place on the given number of threads. Nothing is done if the table is
+   * already sorted.
+   *
+   * <strong>Internal Called Functions:</strong>
+   * <ul>
+   * <li>parallel_for</li>
+   * </ul>
+   * <strong>External Called Functions:</strong>
+   * <ul>
+   * <li>std::sort</li>
+   * </ul>
+   *
+   * @post The table is sorted and held in owned buffers unless it was sorted
+   * already.
+   *
+   * @param threads Number of threads.
+   */
+  void sort(unsigned threads = 1);
+
+  /**
+   * @brief Writes the table as a binary candidate file.
+   *
+   * Writes the table as a binary candidate file.
+   *
+   * @param path Path of the file.
+   * @return bool True on success; false otherwise.
+   */
+  bool write(std::string const& path) const;
+
+  /**
+   * @brief Writes the table in the text format written by A and B.
+   *
+   * Writes the table in the text format written by A and B.
+   *
+   * @param os std::ostream object.
+   */
+  void write_text(std::ostream& os) const;
+
+  /**
+   * @brief Entry of a sequence.
+   *
+   * Entry of a sequence.
+   *
+   * @param i Index of sequence.
+   * @param j Index of entry.
+   * @return int Entry +1 or -1.
+   */
+  int at(std::size_t i, std::size_t j) const
+  {
+    return (bits[i * words + (j >> 6U)] >> (j & 63U)) & 1U ? -1 : 1;
+  }
+
+  psdfile_t& operator=(psdfile_t const&) & = delete;
+  psdfile_t& operator=(psdfile_t &&) & = delete;
+
+  psdfile_t() = default;
+  psdfile_t(psdfile_t const&) = delete;
+  psdfile_t(psdfile_t &&) = delete;
+
+  /**
+   * @brief Destructor.
+   *
+   * Destructor. Unmaps the file if one is mapped.
+   */
+  ~psdfile_t();
+
+  unsigned n{};                 ///< length of sequences
+  unsigned len{};               ///< psd values per sequence
+  unsigned words{};             ///< 64-bit words per packed sequence
+  std::size_t count{};          ///< number of sequences
+  bool sorted{};                ///< sorted lexicographically by psd
+
+  double const        *psd{};   ///< psd values, len per sequence
+  std::uint64_t const *bits{};  ///< packed sequences, words per sequence
+
+  buffer_t<double>        psdbuf{};  ///< owned psd values
+  buffer_t<std::uint64_t> bitbuf{};  ///< owned packed sequences
+
+  void        *map{};           ///< mapped file
+  std::size_t  mapsize{};       ///< size of mapped file
+};
+
+/**
+ * @brief Streaming writer of binary candidate files.
+ *
+ * Streaming writer of binary candidate files. The psd values are written to the
+ * file as the sequences arrive while the packed sequences, which are a small
+ * fraction of the size, are held in memory and appended when the file is closed.
+ * The header is then rewritten with the final count, so the file must be
+ * seekable.
+ *
+ * For a run that may be resumed the packed sequences are also spilled to a side
+ * file at every sync, so the file and the side file together hold every
+ * sequence written up to the last sync.
+ */
+struct psdwriter_t
+{
+  /**
+   * @brief Opens the file and writes a provisional header.
+   *
+   * Opens the file and writes a provisional header.
+   *
+   * @param path Path of the file.
+   * @param _n Length of sequences.
+   * @param spill Path of the side file; none if empty.
+   * @return bool True on success; false otherwise.
+   */
+  bool open(std::string const& path, unsigned _n, std::string const& spill = {});
+
+  /**
+   * @brief Reopens a file left unclosed to continue writing it.
+   *
+   * Reopens a file left unclosed to continue writing it. Anything written to the
+   * file or the side file after the sync at which count sequences had been
+   * written is discarded.
+   *
+   * <strong>External Called Functions:</strong>
+   * <ul>
+   * <li>ftruncate</li>
+   * </ul>
+   *
+   * @post On success count sequences are held and further sequences are
+   * appended.
+   *
+   * @param path Path of the file.
+   * @param _n Length of sequences.
+   * @param _count Number of sequences written at the sync.
+   * @param spill Path of the side file.
+   * @return bool True on success; false otherwise.
+   */
+  bool resume(std::string const& path, unsigned _n, std::size_t _count,
+              std::string const& spill);
+
+  /**
+   * @brief Writes everything appended so far to stable storage.
+   *
+   * Writes everything appended so far to stable storage: the packed sequences
+   * not yet spilled are appended to the side file, and both files are flushed.
+   *
+   * <strong>External Called Functions:</strong>
+   * <ul>
+   * <li>fsync</li>
+   * </ul>
+   *
+   * @pre The file was opened with a side file.
+   *
+   * @return bool True on success; false otherwise.
+   */
+  bool sync();
+
+  /**
+   * @brief Appends a sequence.
+   *
+   * Appends a sequence.
+   *
+   * @param b Packed sequence of words words.
+   * @param p psd values of the sequence, len of them.
+   */
+  void put(std::uint64_t const *b, double const *p);
+
+  /**
+   * @brief Appends a buffer of records.
+   *
+   * Appends a buffer of records, each the packed sequence followed by its psd
+   * values, as written by encounter_func.
+   *
+   * @param s Buffer of records.
+   */
+  void put_records(std::string const& s);
+
+  /**
+   * @brief Appends the packed sequences and writes the final header.
+   *
+   * Appends the packed sequences and writes the final header.
+   *
+   * @return bool True on success; false otherwise.
+   */
+  bool close();
+
+  psdwriter_t& operator=(psdwriter_t const&) & = delete;
+  psdwriter_t& operator=(psdwriter_t &&) & = delete;
+
+  psdwriter_t() = default;
+  psdwriter_t(psdwriter_t const&) = delete;
+  psdwriter_t(psdwriter_t &&) = delete;
+
+  ~psdwriter_t() { if ( F ) close(); }
+
+  unsigned n{};                      ///< length of sequences
+  unsigned len{};                    ///< psd values per sequence
+  unsigned words{};                  ///< 64-bit words per packed sequence
+  std::size_t count{};               ///< sequences written
+  bool sorted{};                     ///< sequences were written sorted by psd
+  std::vector<std::uint64_t> bits{}; ///< packed sequences held until close
+  std::FILE *F{};                    ///< file being written
+  std::FILE *S{};                    ///< side file; null if none
+  std::size_t spilled{};             ///< sequences spilled to the side file
+};
+
+# endif
@@ -0,0 +1,91 @@
+/**
+ * @file psdmerge.c++
+ * @brief File to generate executable merging the candidate files written by the
+ * shards of a run of A or B.
+ *
+ * File to generate executable merging the candidate files written by the shards
+ * of a run of A or B; see the option -s of A and B. The shards test disjoint sets
+ * of bracelets, so their candidates are concatenated, in the order the files are
+ * given, and optionally sorted by psd. The files may be text or binary and are
+ * held in memory while merging.
+ *
+ * <dl>
+ * <dt><strong>Usage</strong></dt>
+ * <dd>./psdmerge [-s] [-t] [-j threads] outfile infile...</dd>
+ * </dl>
+ * <strong>Parameters</strong>
+ * <ul>
+ * <li><strong>-s --</strong> sort the sequences by psd, as done by whiteman;
+ * a sorted binary file is read by whiteman without copying</li>
+ * <li><strong>-t --</strong> write text instead of a binary candidate file</li>
+ * <li><strong>-j threads --</strong> number of threads parsing and sorting
+ * (default 1)</li>
+ * <li><strong>outfile --</strong> merged file; - writes text to stdout</li>
+ * <li><strong>infile --</strong> candidate files of the shards</li>
+ * </ul>
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# include <fstream>
+# include <iostream>
+# include <sstream>
+# include <string>
+
+# include <unistd.h>
+
+# include <psdfile.h++>
+
+int main(int argc, char *argv[])
+{
+  bool sort{}, text{}, ok{true};
+  unsigned threads{1};
+
+  int c{};
+  while ( (c = getopt(argc, argv, "stj:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 's': sort = true; break;
+    case 't': text = true; break;
+    case 'j': ss >> threads; break;
+    default: ok = false; break;
+    }
+  }
+
+  if ( !ok || argc - optind < 2 || threads == 0 ) {
+    std::cerr << "USAGE -- ./psdmerge [-s] [-t] [-j <threads>] <outfile> "
+              << "<infile>...\n" << std::flush;
+    return 1;
+  }
+
+  std::string out{argv[optind]};
+  text = text || out == "-";
+
+  psdfile_t M;
+  for ( int i{optind + 1}; i < argc; i++ ) {
+    psdfile_t F;
+    if ( !F.load(argv[i], threads) ) return 1;
+    if ( !M.append(F) ) {
+      std::cerr << "ERROR -- " << argv[i] << " holds sequences of length "
+                << F.n << ", expected " << M.n << '\n' << std::flush;
+      return 1;
+    }
+  }
+  if ( sort ) M.sort(threads);
+
+  if ( !text ) return M.write(out) ? 0 : 1;
+
+  if ( out == "-" ) {
+    M.write_text(std::cout);
+    return std::cout.flush() ? 0 : 1;
+  }
+
+  std::ofstream os{out};
+  M.write_text(os);
+  if ( !os.flush() ) {
+    std::cerr << "ERROR -- cannot write " << out << '\n' << std::flush;
+    return 1;
+  }
+  return 0;
+}
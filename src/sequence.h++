@@ -1,10 +1,11 @@
 /**
  * @file sequence.h++
- * @brief Interface for seq_t class that holds a sequence and its out-of-phase
- * power spectral densities.
+ * @brief Interface for sequence_t class that views a sequence and its
+ * out-of-phase power spectral densities.
  *
- * Interface for seq_t class that holds a sequence and its out-of-phase power
- * spectral densities. The class is a helper class for the executable whiteman.
+ * Interface for sequence_t class that views a sequence and its out-of-phase power
+ * spectral densities held in a psdfile_t table. The class is a helper class for
+ * the executable whiteman.
  *
  * @author Thomas Pender
  * @date 10/2025
@@ -16,15 +17,17 @@
 # include <iostream>
 # include <vector>
 
-# define ERR 0.00005
+# include <lengths.h++>
+# include <psdfile.h++>
+# include <stats.h++>
 
-using seq = std::vector<int>;
-using psdseq = std::vector<double>;
+# define ERR 0.00005
 
 /**
- * @brief A class to hold a sequence and its psd sequence.
+ * @brief A class to view a sequence and its psd sequence.
  *
- * A class to hold a sequence and its psd sequence.
+ * A class to view a sequence and its psd sequence held in a psdfile_t table. The
+ * object does not own the data it views.
  */
 struct sequence_t
 {
@@ -39,41 +42,24 @@ struct sequence_t
    */
   friend std::ostream& operator<<(std::ostream& os, sequence_t const& s)
   {
-    for ( auto x : s.a ) os << x << " ";
+    for ( std::size_t i{0}; i < s.n; i++ ) os << s[i] << " ";
     os << '\n';
     return os;
   }
 
   /**
-   * @brief Read in sequence_t object.
-   *
-   * Read in sequence_t object.
+   * @brief Entry of the sequence.
    *
-   * @param is std::istream object.
-   * @param s sequence_t object be read in.
-   * @return std::istream object.
-   */
-  friend std::istream& operator>>(std::istream& is, sequence_t& s)
-  {
-    for ( auto& x : s.a ) is >> x;
-    for ( auto& x : s.psd ) is >> x;
-    return is;
-  }
-
-  /**
-   * @brief Ordering of sequence_t objects.
+   * Entry of the sequence.
    *
-   * Ordering of sequence_t objects.
+   * @param i Index of entry.
+   * @return int Entry +1 or -1.
    */
-  friend auto operator<=>(sequence_t const& s1, sequence_t const& s2)
+  int operator[](std::size_t i) const
   {
-    return s1.psd <=> s2.psd;
+    return (a[i >> 6U] >> (i & 63U)) & 1U ? -1 : 1;
   }
 
-  int& operator[](std::size_t i) & {return a[i];}
-  int const& operator[](std::size_t i) const& {return a[i];}
-  int operator[](std::size_t i) && {return std::move(a[i]);}
-
   sequence_t& operator=(sequence_t const&) & = default;
   sequence_t& operator=(sequence_t &&) & noexcept = default;
 
@@ -86,52 +72,88 @@ struct sequence_t
    *
    * Standard constructor.
    *
-   * @param _n Length of sequence to be constructed.
+   * @param F Table holding the sequence.
+   * @param i Index of the sequence in the table.
    */
-  explicit sequence_t(unsigned _n)
-    : n{_n}, bound{(_n << 2U) + 4U}, a(_n), psd(_n >> 1U)
+  sequence_t(psdfile_t const& F, std::size_t i)
+    : n{F.n}, bound{(F.n << 2U) + 4U}, len{F.len}, a{F.bits + i * F.words},
+      psd{F.psd + i * F.len}
   {}
 
   ~sequence_t() = default;
 
-  unsigned n;     ///< length of sequences
-  unsigned bound; ///< psd bound for sequence of given length
-  seq a{};        ///< std::vector<int> holding sequence
-  psdseq psd{};   ///< std::vector<double> holding power spectral densities
+  unsigned n{};                ///< length of sequences
+  unsigned bound{};            ///< psd bound for sequence of given length
+  unsigned len{};              ///< number of psd values
+  std::uint64_t const *a{};    ///< packed sequence, see psdfile.h++
+  double const *psd{};         ///< power spectral densities
 };
 
 /**
  * @brief Print 4-set of sequences.
  *
- * Print 4-set of sequences.
+ * Print 4-set of sequences. The stream is not flushed; the caller flushes once
+ * per block of work.
  *
+ * @param os std::ostream object.
  * @param s1 First sequence.
  * @param s2 Second sequence.
  * @param s3 Third sequence.
  * @param s4 Fourth sequence.
  */
 static inline
-void pr(sequence_t const& s1, sequence_t const& s2,
+void pr(std::ostream& os, sequence_t const& s1, sequence_t const& s2,
         sequence_t const& s3, sequence_t const& s4)
 {
-  std::cout << s1 << s2 << s3 << s4 << '\n' << std::flush;
+  os << s1 << s2 << s3 << s4 << '\n';
+}
+
+/**
+ * @brief Psd test for a pair of sequences, not counted.
+ *
+ * Psd test for a pair of sequences, not counted by the statistics of
+ * check_bound. The test stops at the first failing value, since most pairs fail
+ * early; the number H of psd values is a compile-time constant unless zero, so
+ * the loop has a constant trip count.
+ *
+ * @param s1 First sequence.
+ * @param s2 Second sequence.
+ * @return True if the pair passes the test else false.
+ */
+template <unsigned H = 0>
+static inline
+bool within_bound(sequence_t const& s1, sequence_t const& s2)
+{
+  double const lim{s1.bound + ERR};
+  std::size_t const len{extent<H>(s1.len)};
+  for ( std::size_t i{0}; i < len; i++ )
+    if ( s1.psd[i] + s2.psd[i] > lim ) return false;
+  return true;
 }
 
 /**
  * @brief Psd test for a pair of sequences.
  *
- * Psd test for a pair of sequences.
+ * Psd test for a pair of sequences (i1, i2) of the search, counted by
+ * count_bound; see within_bound.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>within_bound</li>
+ * <li>count_bound</li>
+ * </ul>
  *
  * @param s1 First sequence.
  * @param s2 SEcond sequence.
  * @return True if the pair passes the test else false.
  */
+template <unsigned H = 0>
 static inline
 bool check_bound(sequence_t const& s1, sequence_t const& s2)
 {
-  for ( std::size_t i{0}; i < s1.psd.size(); i++ )
-    if ( s1.psd[i] + s2.psd[i] > s1.bound + ERR ) return false;
-  return true;
+  bool const pass{within_bound<H>(s1, s2)};
+  count_bound(pass);
+  return pass;
 }
 
 # endif
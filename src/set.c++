@@ -11,6 +11,7 @@
  */
 # include <algorithm>
 
+# include <hash.h++>
 # include <set.h++>
 
 static const
@@ -55,51 +56,59 @@ int cross_corr(int j, seq const& s1, seq const& s2)
  * <li>cross_corr<li>
  * </ul>
  *
- * @pre The two std::vector<int> instances are assumed to be of the same size.
+ * @pre The std::vector<int> instances are assumed to be of the same size.
  *
- * @post The vector of out-of-phase cross corrrelations is constructed.
+ * @post The vector of out-of-phase cross corrrelations is written to corrs.
  *
  * @param s1 First sequence.
  * @param s2 Second sequence.
- * @return Vector of cross-correlations.
+ * @param corrs Vector of cross-correlations.
  */
 static inline
-seq cross_corrs(seq const& s1, seq const& s2)
+void cross_corrs(seq const& s1, seq const& s2, seq& corrs)
 {
-  seq corrs(s1.size());
-  for ( int j{0}; j < s1.size(); j++ ) corrs[j] = cross_corr(j, s1, s2);
-  return corrs;
+  for ( std::size_t j{0}; j < s1.size(); j++ ) corrs[j] = cross_corr(j, s1, s2);
 }
 
 /**
- * @brief Constructs the possible rotations of std::vector<int> and the difference
- * between the rotations and their transposes.
+ * @brief Constructs the differences between the rotations of std::vector<int>
+ * and their transposes, and their hashes.
  *
- * Constructs the possible rotations of std::vector<int> and the difference
- * between the rotations and their transposes.
+ * Constructs the differences between the rotations of std::vector<int> and their
+ * transposes, and their hashes. Row i of the table holds, at index j, the entry
+ * j minus the entry n-j of the ith rotation of the sequence, for j < n/2.
+ *
+ * <strong>Internal Functions Called:</strong>
+ * <ul>
+ * <li>linear_hash<li>
+ * </ul>
+ *
+ * @pre The table has room for n rows of n/2 entries and H for n hashes.
+ *
+ * @post The table and the hash of each of its rows are written.
  *
  * @param s Sequence being rotated.
- * @return The difference between the rotations of a sequence and their transposes.
+ * @param T Flat table of the differences, n/2 entries per rotation.
+ * @param H Hash of each row of the table.
  */
 static
-seqs rotations(seq const& s)
+void rotations(seq const& s, std::vector<int>& T, std::vector<std::uint64_t>& H)
 {
-  seqs S(s.size(), seq(s.size()));
-
-  std::size_t i{}, j{}, J{};
-  for ( i = 0; i < s.size(); i++ )
-    for ( j = 0; j < s.size(); j++ ) {
-      J = j + i;
-      J = (J < s.size() ? J : J - s.size());
-      S[i][j] = s[J];
+  std::size_t const n{s.size()}, h{s.size() / 2};
+
+  std::size_t i{}, j{}, J{}, K{};
+  for ( i = 0; i < n; i++ ) {
+    int *t{T.data() + i * h};
+    t[0] = 0;
+    for ( j = 1; j < h; j++ ) {
+      J = i + j;
+      J = (J < n ? J : J - n);
+      K = i + n - j;
+      K = (K < n ? K : K - n);
+      t[j] = s[J] - s[K];
     }
-
-  seqs T(s.size(), seq(s.size() / 2));
-  for ( i = 0; i < s.size(); i++ )
-    for ( j = 1; j < T[i].size(); j++ )
-      T[i][j] = S[i][j] - S[i][s.size() - j];
-
-  return T;
+    H[i] = linear_hash(t, h);
+  }
 }
 
 /**
@@ -107,6 +116,11 @@ seqs rotations(seq const& s)
  * amicable set.
  *
  * Determines whether a 4-set of sequences can be transformed into an amicable set.
+ * The rotations i1 of the first pair are indexed by the hash of their
+ * differences; for every rotation i2 of the second pair the negated and the
+ * un-negated differences are looked up, and the first hit, in the order of i1,
+ * then i2, is verified and applied. This is the same transformation as found by
+ * testing every pair (i1, i2) in turn.
  *
  * @pre The set_t object is assmued to house at least 4 sequences.
  * @post Each of the possible transformations of the 4-set of sequences are tested
@@ -114,12 +128,15 @@ seqs rotations(seq const& s)
  *
  * <strong>Internal Function Called:</strong>
  * <ul>
+ * <li>cross_corrs</li>
  * <li>rotations</li>
  * <li>set_t::apply_perm</li>
  * <li>set_t::negate</li>
  * </ul>
  * <strong>External Functions Called:</strong>
  * <ul>
+ * <li>std::sort</li>
+ * <li>std::lower_bound</li>
  * <li>std::rotate</li>
  * </ul>
  *
@@ -131,53 +148,58 @@ seqs rotations(seq const& s)
 static
 bool _amicable(set_t& s, perm const& p)
 {
-  seqs corrs1{rotations(cross_corrs(s[p[0]], s[p[1]]))};
-  seqs corrs2{rotations(cross_corrs(s[p[2]], s[p[3]]))};
-
-  bool flag{}, neg{};
-  std::size_t i1{}, i2{}, j{};
-  for ( i1 = 0; i1 < corrs1.size(); i1++ )
-    for ( i2 = 0; i2 < corrs2.size(); i2++ ) {
-      flag = true;
-      neg = true;
-      for ( j = 0; j < corrs1[0].size(); j++ ) {
-        if ( corrs1[i1][j] + corrs2[i2][j] != 0 ) flag = false;
-        if ( -corrs1[i1][j] + corrs2[i2][j] != 0 ) neg = false;
-        if ( !flag && !neg ) break;
-      }
-      if ( flag ) {
-        s.apply_perm(p);
-        std::rotate(s[1].rbegin(), s[1].rbegin() + i1, s[1].rend());
-        std::rotate(s[3].rbegin(), s[3].rbegin() + i2, s[3].rend());
-        std::cout << s << '\n';
-
-        neg = false;
-        return true;
-      }
-      if ( neg ) {
-        s.apply_perm(p);
-        s.negate();
-        std::rotate(s[1].rbegin(), s[1].rbegin() + i1, s[1].rend());
-        std::rotate(s[3].rbegin(), s[3].rbegin() + i2, s[3].rend());
-        std::cout << s << '\n';
-
-        return true;
+  scratch_t& w{s.w};
+  std::size_t const n{s.n}, h{s.n / 2};
+
+  cross_corrs(s[p[0]], s[p[1]], w.c1);
+  cross_corrs(s[p[2]], s[p[3]], w.c2);
+  rotations(w.c1, w.T1, w.H1);
+  rotations(w.c2, w.T2, w.H2);
+
+  for ( std::size_t i{0}; i < n; i++ ) w.I[i] = {w.H1[i], unsigned(i)};
+  std::sort(w.I.begin(), w.I.end());
+
+  std::size_t i1{n}, i2{n}, j{};
+  bool neg{};
+  for ( std::size_t k{0}; k < n; k++ )
+    for ( bool x : {false, true} ) {
+      std::uint64_t const key{x ? w.H2[k] : 0 - w.H2[k]};
+      auto it{std::lower_bound(w.I.begin(), w.I.end(),
+                               std::pair<std::uint64_t, unsigned>{key, 0})};
+      for ( ; it != w.I.end() && it->first == key; it++ ) {
+        std::size_t const i{it->second};
+        if ( i > i1 || (i == i1 && (k > i2 || (k == i2 && x >= neg))) ) break;
+
+        int const *t1{w.T1.data() + i * h}, *t2{w.T2.data() + k * h};
+        for ( j = 0; j < h; j++ )
+          if ( (x ? -t1[j] : t1[j]) + t2[j] != 0 ) break;
+        if ( j < h ) continue;
+
+        i1 = i; i2 = k; neg = x;
+        break;
       }
     }
 
-  return false;
+  if ( i1 == n ) return false;
+
+  s.apply_perm(p);
+  if ( neg ) s.negate();
+  std::rotate(s[1].rbegin(), s[1].rbegin() + i1, s[1].rend());
+  std::rotate(s[3].rbegin(), s[3].rbegin() + i2, s[3].rend());
+
+  return true;
 }
 
-void set_t::amicable()
+bool set_t::amicable()
 {
   for ( auto const& p : P )
-    if ( _amicable(*this, p) ) return;
+    if ( _amicable(*this, p) ) return true;
 
   for ( auto const& p : P ) {
     std::swap(s[p[3]], r[p[3]]);
     // seq tmp{s[p[3]]};
     std::reverse(s[p[3]].begin(), s[p[3]].end());
-    if ( _amicable(*this, p) ) return;
+    if ( _amicable(*this, p) ) return true;
     // s[p[3]] = std::move(tmp);
     std::swap(s[p[3]], r[p[3]]);
   }
@@ -186,7 +208,7 @@ void set_t::amicable()
     std::swap(s[p[1]], r[p[1]]);
     // seq tmp{s[p[1]]};
     std::reverse(s[p[1]].begin(), s[p[1]].end());
-    if ( _amicable(*this, p) ) return;
+    if ( _amicable(*this, p) ) return true;
     // s[p[1]] = std::move(tmp);
     std::swap(s[p[1]], r[p[1]]);
   }
@@ -198,12 +220,12 @@ void set_t::amicable()
     // seq tmp2{s[p[3]]};
     std::reverse(s[p[1]].begin(), s[p[1]].end());
     std::reverse(s[p[3]].begin(), s[p[3]].end());
-    if ( _amicable(*this, p) ) return;
+    if ( _amicable(*this, p) ) return true;
     // s[p[1]] = std::move(tmp1);
     // s[p[3]] = std::move(tmp2);
     std::swap(s[p[1]], r[p[1]]);
     std::swap(s[p[3]], r[p[3]]);
   }
 
-  return;
+  return false;
 }
@@ -12,7 +12,11 @@
 # ifndef INCLUDED_SET_HPP
 # define INCLUDED_SET_HPP
 
+# include <algorithm>
+# include <array>
+# include <cstdint>
 # include <iostream>
+# include <utility>
 # include <vector>
 
 using seq = std::vector<int>;
@@ -53,6 +57,45 @@ std::ostream& operator<<(std::ostream& os, seq const& s)
   return os;
 }
 
+/**
+ * @brief Scratch space of the amicability test.
+ *
+ * Scratch space of the amicability test, allocated once per set_t object so the
+ * test allocates nothing per set.
+ */
+struct scratch_t
+{
+  scratch_t& operator=(scratch_t const&) & = default;
+  scratch_t& operator=(scratch_t &&) & noexcept = default;
+
+  scratch_t() = default;
+  scratch_t(scratch_t const&) = default;
+  scratch_t(scratch_t &&) noexcept = default;
+
+  /**
+   * @brief Standard constructor.
+   *
+   * Standard constructor.
+   *
+   * @post Buffers for sequences of length n are allocated.
+   *
+   * @param n Length of sequences.
+   */
+  explicit scratch_t(unsigned n)
+    : c1(n), c2(n), T1(n * (n >> 1U)), T2(n * (n >> 1U)), H1(n), H2(n), I(n)
+  {}
+
+  ~scratch_t() = default;
+
+  seq c1{};                     ///< cross-correlations of the first pair
+  seq c2{};                     ///< cross-correlations of the second pair
+  std::vector<int> T1{};        ///< rotation table of c1, n/2 per rotation
+  std::vector<int> T2{};        ///< rotation table of c2, n/2 per rotation
+  std::vector<std::uint64_t> H1{}; ///< hash of each row of T1
+  std::vector<std::uint64_t> H2{}; ///< hash of each row of T2
+  std::vector<std::pair<std::uint64_t, unsigned>> I{}; ///< H1 sorted
+};
+
 /**
  * @brief Class to hold 4-set of complementary sequences and their reversals.
  *
@@ -117,12 +160,9 @@ struct set_t
    */
   void apply_perm(perm const& p)
   {
-    seqs S(4);
-    S[0] = std::move(s[p[0]]);
-    S[1] = std::move(s[p[1]]);
-    S[2] = std::move(s[p[2]]);
-    S[3] = std::move(s[p[3]]);
-    s = std::move(S);
+    std::array<seq, 4> S;
+    for ( std::size_t i{0}; i < 4; i++ ) S[i] = std::move(s[p[i]]);
+    for ( std::size_t i{0}; i < 4; i++ ) s[i] = std::move(S[i]);
   }
 
   /**
@@ -153,8 +193,11 @@ struct set_t
    * @pre set_t object has at least 4 sequences stored.
    * @post If there is an equivalent amicable set, the set is transformed to it;
    * otherwise, nothing is done.
+   *
+   * @return True if the set was transformed to an amicable set, false
+   * otherwise.
    */
-  void amicable();
+  bool amicable();
 
   seq& operator[](std::size_t i) & {return s[i];}
   seq const& operator[](std::size_t i) const& {return s[i];}
@@ -175,11 +218,12 @@ struct set_t
    * @post length of the sequences assigned.
    * @post std::vector<std::vector<int> > allocated to hold 4 sequences of length
    * n.
+   * @post Scratch space of the amicability test allocated.
    *
    * @param _n Length of sequences being read in.
    */
   explicit set_t(unsigned _n)
-    : n{_n}, s(4, seq(n))
+    : n{_n}, s(4, seq(n)), w{_n}
   {}
 
   ~set_t() = default;
@@ -187,6 +231,7 @@ struct set_t
   unsigned n{}; ///< sequence length
   seqs s{};     ///< std::vector<std::vector<int> > holding sequences
   seqs r{};     ///< std::vector<std::vector<int> > holding reversals
+  scratch_t w{}; ///< scratch space of the amicability test
 };
 
 # endif
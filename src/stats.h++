@@ -0,0 +1,182 @@
+/**
+ * @file stats.h++
+ * @brief Counters of the hot paths of A, B, whiteman and amicable.
+ *
+ * Counters of the hot paths of A, B, whiteman and amicable: the bracelets tested,
+ * the psd test rejections per frequency, the pairs tested by check_bound and
+ * passing it, and the steps of the two-pointer walk. The counters are compiled in
+ * only if the macro LEGENDRE_STATS is defined, e.g. by configure --enable-stats;
+ * otherwise the counting functions are empty and no code is generated for them.
+ *
+ * Each thread counts into its own counters, which are added to the totals when
+ * the thread exits. The totals are written as JSON at exit, to stderr or to the
+ * file named by the environment variable LEGENDRE_STATS_FILE. The entry k of
+ * psd_rejects counts the sequences rejected at frequency k; frequency 0 is never
+ * tested.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_STATS_HPP
+# define INCLUDED_STATS_HPP
+
+# include <cstddef>
+
+# ifdef LEGENDRE_STATS
+
+# include <cstdio>
+# include <cstdlib>
+# include <mutex>
+# include <vector>
+
+/**
+ * @brief Counters of the hot paths.
+ *
+ * Counters of the hot paths.
+ */
+struct stats_t
+{
+  /**
+   * @brief Adds counters to these.
+   *
+   * Adds counters to these.
+   *
+   * @param x Counters being added.
+   */
+  void add(stats_t const& x)
+  {
+    bracelets += x.bracelets;
+    tests += x.tests;
+    passes += x.passes;
+    steps += x.steps;
+    if ( rejects.size() < x.rejects.size() ) rejects.resize(x.rejects.size());
+    for ( std::size_t k{0}; k < x.rejects.size(); k++ )
+      rejects[k] += x.rejects[k];
+  }
+
+  /**
+   * @brief Writes the counters as JSON.
+   *
+   * Writes the counters as JSON, to stderr or to the file named by the
+   * environment variable LEGENDRE_STATS_FILE. The C stdio is used since the
+   * counters are written during static destruction.
+   */
+  void dump() const
+  {
+    char const *path{std::getenv("LEGENDRE_STATS_FILE")};
+    std::FILE *F{path ? std::fopen(path, "w") : stderr};
+    if ( !F ) return;
+
+    std::fprintf(F, "{\"bracelets\": %llu, \"psd_rejects\": [", bracelets);
+    for ( std::size_t k{0}; k < rejects.size(); k++ )
+      std::fprintf(F, "%s%llu", k ? ", " : "", rejects[k]);
+    std::fprintf(F, "], \"check_bound\": {\"tests\": %llu, \"passes\": %llu, "
+                 "\"pass_rate\": %.6f}, \"two_pointer_steps\": %llu}\n",
+                 tests, passes, tests ? double(passes) / tests : 0.0, steps);
+
+    if ( F != stderr ) std::fclose(F);
+  }
+
+  unsigned long long bracelets{}; ///< bracelets tested
+  unsigned long long tests{};     ///< pairs tested by check_bound
+  unsigned long long passes{};    ///< pairs passing check_bound
+  unsigned long long steps{};     ///< steps of the two-pointer walk
+  std::vector<unsigned long long> rejects{}; ///< psd rejections per frequency
+};
+
+/**
+ * @brief Totals of the counters of all threads, written out at exit.
+ *
+ * Totals of the counters of all threads, written out at exit.
+ */
+struct stats_totals_t
+{
+  ~stats_totals_t() { sum.dump(); }
+
+  stats_t sum{};      ///< totals
+  std::mutex mtx{};   ///< guards the totals
+};
+
+inline stats_totals_t stats_totals{};
+
+/**
+ * @brief Counters of a thread, added to the totals when it exits.
+ *
+ * Counters of a thread, added to the totals when it exits.
+ */
+struct stats_local_t
+{
+  ~stats_local_t()
+  {
+    std::lock_guard<std::mutex> lock{stats_totals.mtx};
+    stats_totals.sum.add(s);
+  }
+
+  stats_t s{}; ///< counters of the thread
+};
+
+inline thread_local stats_local_t stats_local{};
+
+# endif
+
+/**
+ * @brief Counts a bracelet tested.
+ *
+ * Counts a bracelet tested.
+ */
+static inline
+void count_bracelet()
+{
+# ifdef LEGENDRE_STATS
+  stats_local.s.bracelets++;
+# endif
+}
+
+/**
+ * @brief Counts a rejection by the psd test.
+ *
+ * Counts a rejection by the psd test.
+ *
+ * @param k Frequency at which the sequence was rejected.
+ */
+static inline
+void count_reject([[maybe_unused]] std::size_t k)
+{
+# ifdef LEGENDRE_STATS
+  std::vector<unsigned long long>& r{stats_local.s.rejects};
+  if ( r.size() <= k ) r.resize(k + 1);
+  r[k]++;
+# endif
+}
+
+/**
+ * @brief Counts a pair tested by check_bound.
+ *
+ * Counts a pair tested by check_bound.
+ *
+ * @param pass Whether the pair passed.
+ */
+static inline
+void count_bound([[maybe_unused]] bool pass)
+{
+# ifdef LEGENDRE_STATS
+  stats_local.s.tests++;
+  stats_local.s.passes += pass;
+# endif
+}
+
+/**
+ * @brief Counts a step of the two-pointer walk.
+ *
+ * Counts a step of the two-pointer walk.
+ */
+static inline
+void count_step()
+{
+# ifdef LEGENDRE_STATS
+  stats_local.s.steps++;
+# endif
+}
+
+# endif
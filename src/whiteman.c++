@@ -10,77 +10,104 @@
  *
  * <dl>
  * <dt><strong>Usage</strong></dt>
- * <dd>./whiteman N num1 num2 file1 file2</dd>
+ * <dd>./whiteman [-J] [-j threads] [-k] [-b rows] file1 file2</dd>
  * </dl>
  * <strong>Parameters</strong>
  * <ul>
- * <li><strong>N --</strong> length of sequences</li>
- * <li><strong>num1 --</strong> number of sequences in file1</li>
- * <li><strong>num2 --</strong> number of sequences in file2</li>
+ * <li><strong>-J --</strong> search by hash join on the exact autocorrelations
+ * instead of the two-pointer walk over the psds; see join.h++</li>
+ * <li><strong>-j threads --</strong> number of worker threads (default 1)</li>
+ * <li><strong>-k --</strong> keep the output in the single-threaded order</li>
+ * <li><strong>-b rows --</strong> number of sequences i1 of the first type per
+ * block of work handed to a thread (default 1)</li>
  * <li><strong>file1 --</strong> file containing sequences of first type and
  * their psds</li>
  * <li><strong>file2 --</strong> file containing sequences of second type and
  * their psds</li>
  * </ul>
+ * The files are either binary candidate files, which are memory mapped, or text
+ * files as written by A and B; see psdfile.h++. The length of the sequences and
+ * their number are taken from the files.
+ *
+ * With several threads the files are parsed, sorted and indexed in parallel and
+ * the rows i1 are cut into blocks claimed by the threads as they become idle,
+ * since the cost of a row falls off steeply with i1. The tables built from the
+ * files (parsed and sorted psds, autocorrelations and the index of pairs) are
+ * allocated uninitialised and first written by the threads filling them, so on
+ * NUMA machines their pages are spread over the memory nodes of the threads.
+ * Memory-mapped inputs are placed by the kernel; for large ones run under
+ * numactl --interleave=all.
  *
  * @author Thomas Pender
  * @date 10/2025
  * @copyright GNU Public License
  */
+# include <functional>
 # include <iostream>
+# include <memory>
 # include <sstream>
-# include <fstream>
+# include <string>
 # include <vector>
 
+# include <getopt.h>
+
+# include <join.h++>
 # include <sequence.h++>
+# include <workers.h++>
 
-int main(int argc, char *argv[])
+/**
+ * @brief Searches the rows i1 in [lo, hi) by the two-pointer walk.
+ *
+ * Searches the rows i1 in [lo, hi) by the two-pointer walk. For every i1 and
+ * i2 passing the psd test, the sequences j1 >= i1 and j2 >= j1 of the first type
+ * are walked towards each other along the lexicographic order of the psds. The
+ * number H of psd values is a compile-time constant unless zero; see
+ * lengths.h++.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>check_bound</li>
+ * <li>pr</li>
+ * </ul>
+ *
+ * @pre Both tables are sorted and hold sequences of the same length.
+ *
+ * @post The 4-sets found are printed.
+ *
+ * @param A Table of sequences of the first type.
+ * @param B Table of sequences of the second type.
+ * @param lo First row.
+ * @param hi One past the last row.
+ * @param os std::ostream object.
+ */
+template <unsigned H>
+static
+void walk(psdfile_t const& A, psdfile_t const& B,
+          long long lo, long long hi, std::ostream& os)
 {
-  if ( argc < 6 ) {
-    std::cerr << "USAGE -- ./set.out <N> <numA> <numB> <fileA> <fileB>\n"
-              << std::flush;
-    return 1;
-  }
-
-  unsigned n{}, numA{}, numB{};
-  {
-    std::stringstream ss{argv[1]};
-    ss >> n;
-    ss = std::stringstream{argv[2]};
-    ss >> numA;
-    ss = std::stringstream{argv[3]};
-    ss >> numB;
-  }
-
-  long long i1{}, i2{}, j1{}, j2{}, k{};
-  std::ifstream F1{argv[4]}, F2{argv[5]};
-
-  std::vector<sequence_t> seqA(numA, sequence_t{n});
-  for ( auto& x : seqA ) F1 >> x;
-  std::sort(seqA.begin(), seqA.end());
-  F1.close();
+  long long numA = A.count, numB = B.count;
+  long long i1{}, i2{}, j1{}, j2{};
+  std::size_t k{};
+  std::size_t const len{extent<H>(A.len)};
 
-  std::vector<sequence_t> seqB(numB, sequence_t{n});
-  for ( auto& x : seqB ) F2 >> x;
-  std::sort(seqB.begin(), seqB.end());
-  F2.close();
-
-  for ( i1 = 0; i1 < numA; i1++ )
+  for ( i1 = lo; i1 < hi; i1++ )
     for ( i2 = 0; i2 < numB; i2++ ) {
-      if ( !check_bound(seqA[i1], seqB[i2]) ) continue;
+      sequence_t const s1{A, std::size_t(i1)}, s4{B, std::size_t(i2)};
+      if ( !check_bound<H>(s1, s4) ) continue;
       j1 = i1; j2 = numA - 1;
       while ( j1 < numA && j2 >= j1 ) {
+        count_step();
         bool flag{true};
+        double const *p2{A.psd + j1 * len}, *p3{A.psd + j2 * len};
 
-        for ( k = 0; k < seqA[i1].psd.size(); k++ ) {
-          double val{seqA[i1].psd[k] + seqA[j1].psd[k] +
-                     seqA[j2].psd[k] + seqB[i2].psd[k]};
-          if ( val > seqA[i1].bound + ERR ) {
+        for ( k = 0; k < len; k++ ) {
+          double val{s1.psd[k] + p2[k] + p3[k] + s4.psd[k]};
+          if ( val > s1.bound + ERR ) {
             flag = false;
             j2--;
             break;
           }
-          if ( val < seqA[i1].bound - ERR ) {
+          if ( val < s1.bound - ERR ) {
             flag = false;
             j1++;
             break;
@@ -88,11 +115,85 @@ int main(int argc, char *argv[])
         }
 
         if ( flag == true ) {
-          pr(seqA[i1], seqA[j1], seqA[j2], seqB[i2]);
+          pr(os, s1, sequence_t{A, std::size_t(j1)},
+             sequence_t{A, std::size_t(j2)}, s4);
           j1++; j2--;
         }
       }
     }
+}
+
+int main(int argc, char *argv[])
+{
+  bool hashjoin{}, ordered{};
+  unsigned threads{1};
+  unsigned long long rows{1};
+
+  int c{};
+  while ( (c = getopt(argc, argv, "Jj:kb:")) != -1 ) {
+    std::stringstream ss{optarg ? optarg : ""};
+    switch ( c ) {
+    case 'J': hashjoin = true; break;
+    case 'j': ss >> threads; break;
+    case 'k': ordered = true; break;
+    case 'b': ss >> rows; break;
+    default: optind = argc; break;
+    }
+  }
+
+  if ( optind != argc - 2 || threads == 0 || rows == 0 ) {
+    std::cerr << "USAGE -- ./whiteman [-J] [-j <threads>] [-k] [-b <rows>]"
+              << " <fileA> <fileB>\n" << std::flush;
+    return 1;
+  }
+
+  psdfile_t A, B;
+  if ( !A.load(argv[optind], threads) || !B.load(argv[optind + 1], threads) )
+    return 1;
+  if ( A.count && B.count && A.n != B.n ) {
+    std::cerr << "ERROR -- <fileA> and <fileB> hold different lengths\n"
+              << std::flush;
+    return 1;
+  }
+  A.sort(threads);
+  B.sort(threads);
+
+  std::unique_ptr<join_t> J;
+  std::function<void(std::size_t, std::size_t, std::ostream&)> search;
+  if ( hashjoin ) {
+    J = std::make_unique<join_t>(A, B, threads);
+    search = [&J](std::size_t lo, std::size_t hi, std::ostream& os) {
+      J->rows(lo, hi, os);
+    };
+  }
+  else
+    dispatch(A.n, [&](auto N) {
+      constexpr unsigned H{decltype(N)::value / 2};
+      search = [&A, &B](std::size_t lo, std::size_t hi, std::ostream& os) {
+        walk<H>(A, B, lo, hi, os);
+      };
+    });
+
+  if ( threads == 1 ) {
+    search(0, A.count, std::cout);
+    return std::cout.flush() ? 0 : 1;
+  }
+
+  sched_t sched{rows, ordered, [](std::string& s) {
+    std::cout << s << std::flush;
+  }};
+
+  run_workers(threads, [&](unsigned) {
+    std::ostringstream os;
+    for ( unsigned long long b{sched.claim()}; b * rows < A.count;
+          b = sched.claim() ) {
+      search(b * rows, std::min<std::size_t>((b + 1) * rows, A.count), os);
+      std::string s{os.str()};
+      os.str({});
+      sched.submit(b, s);
+    }
+  });
+  sched.flush();
 
-  return 0;
+  return std::cout.flush() ? 0 : 1;
 }
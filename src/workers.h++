@@ -0,0 +1,404 @@
+/**
+ * @file workers.h++
+ * @brief Interface for the block scheduler and worker pool shared by the
+ * threaded executables.
+ *
+ * Interface for the block scheduler and worker pool shared by the threaded
+ * executables, together with helpers for splitting loops and sorts over
+ * threads. Work is cut into numbered blocks which the workers claim from a
+ * shared counter; the output of each block is buffered by the worker and handed
+ * back to the scheduler, which writes it either as soon as it arrives or in
+ * block order.
+ *
+ * @author Thomas Pender
+ * @date 10/2025
+ * @copyright GNU Public License
+ */
+# ifndef INCLUDED_WORKERS_HPP
+# define INCLUDED_WORKERS_HPP
+
+# include <algorithm>
+# include <atomic>
+# include <condition_variable>
+# include <deque>
+# include <functional>
+# include <map>
+# include <memory>
+# include <mutex>
+# include <new>
+# include <string>
+# include <thread>
+# include <type_traits>
+# include <utility>
+# include <vector>
+
+/**
+ * @brief Allocator leaving the elements of a vector uninitialised.
+ *
+ * Allocator leaving the elements of a vector uninitialised: elements created
+ * without a value are default-initialised, which for arithmetic types does not
+ * touch the memory. A table filled by parallel_for is thus first touched by the
+ * threads filling it, which places its pages on their memory nodes.
+ */
+template <typename T>
+struct uninit_t : std::allocator<T>
+{
+  /**
+   * @brief Default-initialises an element.
+   *
+   * Default-initialises an element.
+   *
+   * @param p Address of the element.
+   */
+  template <typename U>
+  void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>)
+  {
+    ::new (static_cast<void*>(p)) U;
+  }
+
+  /**
+   * @brief Constructs an element from arguments.
+   *
+   * Constructs an element from arguments.
+   *
+   * @param p Address of the element.
+   * @param a Arguments of the constructor.
+   */
+  template <typename U, typename... A>
+  void construct(U *p, A&&... a)
+  {
+    ::new (static_cast<void*>(p)) U(std::forward<A>(a)...);
+  }
+
+  uninit_t& operator=(uninit_t const&) & = default;
+  uninit_t& operator=(uninit_t &&) & noexcept = default;
+
+  uninit_t() = default;
+  uninit_t(uninit_t const&) = default;
+  uninit_t(uninit_t &&) noexcept = default;
+
+  template <typename U>
+  uninit_t(uninit_t<U> const&) noexcept {}
+
+  ~uninit_t() = default;
+};
+
+/**
+ * @brief Vector whose elements are left uninitialised on resizing.
+ */
+template <typename T>
+using buffer_t = std::vector<T, uninit_t<T>>;
+
+/**
+ * @brief Scheduler handing out blocks of work and collecting their output.
+ *
+ * Scheduler handing out blocks of work and collecting their output. Blocks are
+ * claimed in increasing order, so a worker that has finished a block always
+ * claims one lying ahead of it. Completed blocks are passed to the sink either
+ * immediately or, if ordered, once every block before them has been written.
+ *
+ * Block b covers the work items starting at start(b). With a stride m and an
+ * offset k the scheduler hands out only every mth block of the whole range,
+ * beginning with the kth, so m schedulers with offsets 0 to m-1 split the work
+ * between them.
+ */
+struct sched_t
+{
+  /**
+   * @brief Claims the next unclaimed block.
+   *
+   * Claims the next unclaimed block.
+   *
+   * @return Index of the claimed block.
+   */
+  unsigned long long claim()
+  {
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief First work item of a block.
+   *
+   * First work item of a block.
+   *
+   * @param b Index of the block.
+   * @return Index of the first work item of the block.
+   */
+  unsigned long long start(unsigned long long b) const
+  {
+    return (b * stride + offset) * size;
+  }
+
+  /**
+   * @brief Skips the blocks before a given one.
+   *
+   * Skips the blocks before a given one, e.g. when resuming from a checkpoint.
+   * Called before any block is claimed.
+   *
+   * @post The blocks with smaller index are never claimed and count as written.
+   *
+   * @param b Index of the first block being handed out.
+   */
+  void skip(unsigned long long b)
+  {
+    next = b;
+    emitted = b;
+  }
+
+  /**
+   * @brief Hands the output of a completed block to the scheduler.
+   *
+   * Hands the output of a completed block to the scheduler.
+   *
+   * @pre Each block index is submitted at most once.
+   *
+   * @post If unordered the output is written by the sink; otherwise it is
+   * written once all blocks with smaller index have been written, after which
+   * the progress function, if any, is called with the number of blocks written.
+   *
+   * @param b Index of the completed block.
+   * @param s Output of the block; its contents are consumed.
+   */
+  void submit(unsigned long long b, std::string& s)
+  {
+    std::lock_guard<std::mutex> lock{mtx};
+    if ( !ordered ) {
+      if ( !s.empty() ) sink(s);
+      return;
+    }
+
+    pending[b] = std::move(s);
+    unsigned long long const before{emitted};
+    while ( !pending.empty() && pending.begin()->first == emitted ) {
+      if ( !pending.begin()->second.empty() ) sink(pending.begin()->second);
+      pending.erase(pending.begin());
+      emitted++;
+    }
+    if ( progress && emitted != before ) progress(emitted);
+  }
+
+  /**
+   * @brief Writes out all blocks still held back.
+   *
+   * Writes out all blocks still held back. Called once the workers are joined.
+   *
+   * @post All submitted output has been passed to the sink in block order.
+   */
+  void flush()
+  {
+    std::lock_guard<std::mutex> lock{mtx};
+    for ( auto& [b, s] : pending )
+      if ( !s.empty() ) sink(s);
+    pending.clear();
+  }
+
+  sched_t& operator=(sched_t const&) & = delete;
+  sched_t& operator=(sched_t &&) & = delete;
+
+  sched_t() = delete;
+  sched_t(sched_t const&) = delete;
+  sched_t(sched_t &&) = delete;
+
+  /**
+   * @brief Standard constructor.
+   *
+   * Standard constructor.
+   *
+   * @param _size Number of work items in a block.
+   * @param _ordered Whether output is written in block order.
+   * @param _sink Function writing out the output of a block.
+   */
+  sched_t(unsigned long long _size, bool _ordered,
+          std::function<void(std::string&)> _sink)
+    : size{_size}, ordered{_ordered}, sink{std::move(_sink)}
+  {}
+
+  ~sched_t() = default;
+
+  unsigned long long size{};                  ///< work items per block
+  bool ordered{};                             ///< write output in block order
+  std::function<void(std::string&)> sink{};   ///< writes out block output
+  unsigned long long stride{1};               ///< blocks of the range between blocks
+  unsigned long long offset{};                ///< first block of the range
+  std::function<void(unsigned long long)> progress{}; ///< called on writes
+
+  std::atomic<unsigned long long> next{};     ///< next unclaimed block
+  std::mutex mtx{};                           ///< guards sink and pending
+  std::map<unsigned long long, std::string> pending{}; ///< held back output
+  unsigned long long emitted{};               ///< next block to be written
+};
+
+/**
+ * @brief Bounded queue passing work between the stages of a pipeline.
+ *
+ * Bounded queue passing work between the stages of a pipeline. Producers block
+ * while the queue is full and consumers while it is empty, until it is closed.
+ */
+template <typename T>
+struct queue_t
+{
+  /**
+   * @brief Appends an element, waiting for room.
+   *
+   * Appends an element, waiting for room.
+   *
+   * @param x Element being appended; its contents are consumed.
+   */
+  void push(T&& x)
+  {
+    std::unique_lock<std::mutex> lock{mtx};
+    notfull.wait(lock, [this] {return q.size() < cap;});
+    q.push_back(std::move(x));
+    notempty.notify_one();
+  }
+
+  /**
+   * @brief Removes the first element, waiting for one.
+   *
+   * Removes the first element, waiting for one.
+   *
+   * @param x Element removed.
+   * @return bool True if an element was removed; false if the queue is closed
+   * and empty.
+   */
+  bool pop(T& x)
+  {
+    std::unique_lock<std::mutex> lock{mtx};
+    notempty.wait(lock, [this] {return !q.empty() || closed;});
+    if ( q.empty() ) return false;
+    x = std::move(q.front());
+    q.pop_front();
+    notfull.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Closes the queue.
+   *
+   * Closes the queue. Consumers drain the remaining elements and then stop.
+   */
+  void close()
+  {
+    std::lock_guard<std::mutex> lock{mtx};
+    closed = true;
+    notempty.notify_all();
+  }
+
+  queue_t& operator=(queue_t const&) & = delete;
+  queue_t& operator=(queue_t &&) & = delete;
+
+  queue_t() = delete;
+  queue_t(queue_t const&) = delete;
+  queue_t(queue_t &&) = delete;
+
+  /**
+   * @brief Standard constructor.
+   *
+   * Standard constructor.
+   *
+   * @param _cap Most elements held at once.
+   */
+  explicit queue_t(std::size_t _cap) : cap{_cap} {}
+
+  ~queue_t() = default;
+
+  std::size_t cap{};                    ///< most elements held at once
+  bool closed{};                        ///< no more elements will be pushed
+  std::deque<T> q{};                    ///< elements held
+  std::mutex mtx{};                     ///< guards the queue
+  std::condition_variable notfull{};    ///< signalled when room is made
+  std::condition_variable notempty{};   ///< signalled on push or close
+};
+
+/**
+ * @brief Runs a function on a number of threads and waits for them.
+ *
+ * Runs a function on a number of threads and waits for them. The function is
+ * called with the index of the thread running it.
+ *
+ * @param j Number of threads.
+ * @param f Function run by each thread.
+ */
+static inline
+void run_workers(unsigned j, std::function<void(unsigned)> const& f)
+{
+  std::vector<std::thread> T;
+  T.reserve(j);
+  for ( unsigned t{0}; t < j; t++ ) T.emplace_back(f, t);
+  for ( auto& x : T ) x.join();
+}
+
+/**
+ * @brief Runs a loop over a range on a number of threads.
+ *
+ * Runs a loop over a range on a number of threads. The range [0, count) is cut
+ * into equal contiguous pieces, one per thread, so each thread touches first the
+ * memory it later works on.
+ *
+ * <strong>Internal Called Functions:</strong>
+ * <ul>
+ * <li>run_workers</li>
+ * </ul>
+ *
+ * @param j Number of threads.
+ * @param count Length of the range.
+ * @param f Function called with the bounds [lo, hi) of each piece.
+ */
+static inline
+void parallel_for(unsigned j, std::size_t count,
+                  std::function<void(std::size_t, std::size_t)> const& f)
+{
+  if ( j <= 1 || count < j ) {
+    f(0, count);
+    return;
+  }
+  run_workers(j, [&](unsigned t) {
+    f(count * t / j, count * (t + 1) / j);
+  });
+}
+
+/**
+ * @brief Sorts a vector on a number of threads.
+ *
+ * Sorts a vector on a number of threads. The pieces of the vector are sorted
+ * stably on their own and then merged pairwise, so the result equals that of
+ * std::stable_sort for any number of threads.
+ *
+ * <strong>External Called Functions:</strong>
+ * <ul>
+ * <li>std::stable_sort</li>
+ * <li>std::inplace_merge</li>
+ * </ul>
+ *
+ * @param j Number of threads.
+ * @param v Vector being sorted.
+ * @param cmp Strict weak ordering of the elements.
+ */
+template <typename V, typename C>
+void parallel_sort(unsigned j, V& v, C cmp)
+{
+  std::size_t const count{v.size()};
+  if ( j <= 1 || count < (std::size_t{j} << 10U) ) {
+    std::stable_sort(v.begin(), v.end(), cmp);
+    return;
+  }
+
+  std::vector<std::size_t> bounds(j + 1);
+  for ( unsigned t{0}; t <= j; t++ ) bounds[t] = count * t / j;
+
+  run_workers(j, [&](unsigned t) {
+    std::stable_sort(v.begin() + bounds[t], v.begin() + bounds[t + 1], cmp);
+  });
+
+  for ( unsigned w{1}; w < j; w <<= 1U ) {
+    std::vector<std::size_t> lo;
+    for ( unsigned t{0}; t + w < j; t += w << 1U ) lo.push_back(t);
+    run_workers(lo.size(), [&](unsigned i) {
+      unsigned t{unsigned(lo[i])};
+      std::inplace_merge(v.begin() + bounds[t], v.begin() + bounds[t + w],
+                         v.begin() + bounds[std::min(t + (w << 1U), j)], cmp);
+    });
+  }
+}
+
+# endif